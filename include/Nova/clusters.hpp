@@ -0,0 +1,51 @@
+#ifndef CLUSTERS_HPP
+#define CLUSTERS_HPP
+
+#include <Nova/types.hpp>
+#include <Nova/const.hpp>
+#include <Nova/job_system.hpp>
+
+namespace Nova
+{
+	//ClusterRange locates one cluster's lights in the light index list, matches a uvec2 in the shaders
+	struct ClusterRange
+	{
+		Nova::UInt offset;
+		Nova::UInt count;
+	};
+
+	//LightClusters splits the view frustum into a CLUSTER_X by CLUSTER_Y by CLUSTER_Z grid
+	//Tiles are even in screen space and depth slices are exponential, so near slices stay thin
+	//Building is pure CPU work and gives the same lists for the same input on any thread count
+	class LightClusters
+	{
+	public:
+		//Lights are world space spheres as (center, radius), their index is their slot in the light buffer
+		void build(const Nova::Matrix4& view, const Nova::Matrix4& proj, Nova::Float zNear, Nova::Float zFar,
+			const Nova::Vector4* lights, Nova::UInt lightCount, Nova::JobSystem& jobs);
+
+		//Cluster index is x + y * CLUSTER_X + z * CLUSTER_X * CLUSTER_Y
+		const Nova::Array<Nova::ClusterRange>& getClusters() const;
+		const Nova::Array<Nova::UInt>& getLightIndices() const;
+
+		//Scale and bias so that slice = floor(log(depth) * scale + bias), shared with the shaders
+		static Nova::Vector2 depthSliceParams(Nova::Float zNear, Nova::Float zFar);
+
+	private:
+		//Inclusive cluster bounds touched by one light, empty when min > max
+		struct LightExtent
+		{
+			Nova::UInt minX, maxX;
+			Nova::UInt minY, maxY;
+			Nova::UInt minZ, maxZ;
+		};
+
+		Nova::Array<LightExtent> extents;
+		Nova::Array<Nova::Array<Nova::UInt>> sliceIndices;
+
+		Nova::Array<Nova::ClusterRange> clusters;
+		Nova::Array<Nova::UInt> lightIndices;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -29,12 +29,34 @@ namespace Nova
             {1.0f, 1.0f, 1.0f}
         };
 
+        //WorldTransform is the composed Transform, only rebuilt when the Transform is set or modified
+        struct WorldTransform
+        {
+            Nova::Matrix4 model;
+            Nova::Matrix3 normal;
+        };
+
         struct Mesh
         {
             Nova::MeshInfo meshInfo;
             Nova::Array<Nova::TextureInfo*> textures;
         };
 
+        //WorldBounds is the mesh bounding sphere in world space, xyz: center, w: radius
+        struct WorldBounds
+        {
+            Nova::Vector4 sphere;
+        };
+
+        //Visibility is written by frustum culling every frame, render systems skip hidden objects
+        struct Visibility
+        {
+            bool visible;
+        };
+
+        //Static marks objects that never move, their shadows are rendered once and cached
+        struct Static {};
+
         struct Camera
         {
             Nova::Float fov;
@@ -58,6 +80,13 @@ namespace Nova
         };
 
         const Camera DEFAULT_CAMERA = { 45.0f, 1.0f, 100.0f };
+
+        //Light travels along direction, so this one shines down at an angle
+        const DirectionalLight DEFAULT_DIRECTIONAL_LIGHT =
+        {
+            { {0.05f, 0.05f, 0.05f}, {0.4f, 0.4f, 0.4f}, {0.0f, 0.0f, 0.0f} },
+            {-0.3f, -1.0f, -0.5f}
+        };
     }
 }
 
@@ -17,11 +17,107 @@ namespace Nova
         constexpr Nova::Float DEG_TO_RAD = 3.1415927f / 180.0f;
         constexpr Nova::Float RAD_TO_DEG = 180.0f / 3.1415927f;
 
+        //Starting value of 64 bit FNV-1a hashes
+        constexpr Nova::UInt64 FNV_OFFSET_BASIS = 14695981039346656037ull;
+
+        //Shared contexts building programs when the driver cannot compile in parallel itself
+        constexpr Nova::UInt SHADER_COMPILE_WORKERS = 2;
+
+        //Shader files are reloaded once they have been quiet this long, editors often write a file in several steps
+        //The watcher wakes at the poll interval, and checks file times at it where there is no inotify
+        constexpr Nova::UInt SHADER_RELOAD_DEBOUNCE_MS = 20;
+        constexpr Nova::UInt SHADER_WATCH_POLL_MS = 10;
+
+        //Linked program binaries are kept here between runs, relative to the working directory like the shaders
+        constexpr const char* PROGRAM_CACHE_DIRECTORY = "../../../shader_cache";
+
         constexpr Nova::UInt OBJECT_NAME_CHARACTER_LIMIT = 256;
         constexpr Nova::UInt FILE_PATH_CHARACTER_LIMIT = 1024;
 
-        constexpr Nova::Int MAX_POINT_LIGHTS = 10;
         constexpr Nova::Int MAX_SPOT_LIGHTS = 3;
+
+        //Buffer binding points shared by every shader program
+        constexpr Nova::UInt FRAME_CONSTANTS_BINDING = 0;
+        constexpr Nova::UInt INSTANCE_DATA_BINDING = 1;
+        constexpr Nova::UInt POINT_LIGHT_BINDING = 2;
+        constexpr Nova::UInt CLUSTER_GRID_BINDING = 3;
+        constexpr Nova::UInt CLUSTER_INDEX_BINDING = 4;
+        constexpr Nova::UInt SHADOW_DATA_BINDING = 5;
+        constexpr Nova::UInt OBJECT_LIGHTS_BINDING = 6;
+        constexpr Nova::UInt PROBE_GRID_BINDING = 7;
+
+        //Texture unit of the cascaded shadow map, above the units material textures use
+        constexpr Nova::UInt SHADOW_MAP_UNIT = 8;
+
+        //Texture unit of the texture array page an object group samples, and the layers in each page
+        constexpr Nova::UInt TEXTURE_ARRAY_UNIT = 9;
+        constexpr Nova::UInt TEXTURE_ARRAY_LAYERS = 16;
+
+        //Starting sizes of the shared mesh pool, in elements
+        constexpr Nova::UInt MESH_POOL_VERTEX_CAPACITY = 1 << 16;
+        constexpr Nova::UInt MESH_POOL_INDEX_CAPACITY = 1 << 18;
+
+        //Frames the CPU may write ahead of the GPU, each owns one region of every stream buffer
+        constexpr Nova::UInt STREAM_BUFFER_REGIONS = 3;
+
+        //Starting region sizes of the per-frame stream buffers, in bytes
+        constexpr Nova::UInt INSTANCE_STREAM_SIZE = 1 << 20;
+        constexpr Nova::UInt INDIRECT_STREAM_SIZE = 1 << 16;
+        constexpr Nova::UInt CLUSTER_STREAM_SIZE = 1 << 18;
+        constexpr Nova::UInt LIGHT_STREAM_SIZE = 1 << 16;
+
+        //Light cluster grid, passed to every shader as defines
+        constexpr Nova::UInt CLUSTER_X = 16;
+        constexpr Nova::UInt CLUSTER_Y = 9;
+        constexpr Nova::UInt CLUSTER_Z = 24;
+        constexpr Nova::UInt CLUSTER_LIGHTS_PER_JOB = 64;
+
+        //Cascaded shadow maps for the directional light, the cascade count is passed to every shader as a define
+        constexpr Nova::UInt SHADOW_CASCADES = 4;
+        constexpr Nova::Int SHADOW_MAP_SIZE = 2048;
+        constexpr Nova::Float SHADOW_DISTANCE = 50.0f;
+        constexpr Nova::Float SHADOW_SPLIT_LAMBDA = 0.75f; //0: uniform splits, 1: logarithmic splits
+        constexpr Nova::Float SHADOW_CASTER_EXTRUSION = 50.0f; //How far toward the light casters are still drawn
+        constexpr Nova::Float SHADOW_SNAP_FRACTION = 0.25f; //Cascades move in steps of this much of their radius
+
+        //Point lights are indexed in a uniform grid of this cell size, lights spanning more cells are kept in a list
+        constexpr Nova::Float LIGHT_GRID_CELL_SIZE = 8.0f;
+        constexpr Nova::UInt LIGHT_GRID_MAX_CELLS = 64;
+
+        //A light stops affecting anything once its attenuated brightness falls below this, the light manager can change it at runtime
+        constexpr Nova::Float LIGHT_ATTENUATION_CUTOFF = 1.0f / 256.0f;
+
+        //Fragments the overdraw view stacks before a pixel turns white, passed to every shader as a define
+        constexpr Nova::Float OVERDRAW_LAYERS = 8.0f;
+
+        //Forward shading reads at most this many point lights per object, passed to every shader as a define
+        constexpr Nova::UInt MAX_OBJECT_LIGHTS = 8;
+        constexpr Nova::UInt OBJECT_LIGHTS_PER_JOB = 64;
+
+        //Light counts the forward shader is specialized for, an object uses the smallest bucket that holds its lights
+        //Buckets one past the previous only hold that exact count, the last must be MAX_OBJECT_LIGHTS
+        constexpr Nova::UInt OBJECT_LIGHT_BUCKETS[] = { 0, 1, 2, 3, 4, 8 };
+        constexpr Nova::UInt OBJECT_LIGHT_BUCKET_COUNT = sizeof(OBJECT_LIGHT_BUCKETS) / sizeof(Nova::UInt);
+
+        //Irradiance probes baked for static scenes, the grid covers the static meshes plus a margin
+        //Grids wider than the max dimension get a larger spacing instead of more probes
+        constexpr Nova::Float PROBE_SPACING = 1.0f;
+        constexpr Nova::Float PROBE_MARGIN = 1.0f;
+        constexpr Nova::Int PROBE_GRID_MAX_DIM = 64;
+        constexpr Nova::UInt PROBES_PER_JOB = 32;
+        constexpr Nova::UInt PROBE_BVH_LEAF_SIZE = 4;
+
+        //Tessellation of the sphere used to benchmark vertex throughput
+        constexpr Nova::UInt DENSE_SPHERE_RINGS = 128;
+        constexpr Nova::UInt DENSE_SPHERE_SEGMENTS = 128;
+        constexpr Nova::Int BENCHMARK_GRID_SIZE = 10;
+
+        //Layers of cubes one behind another in the overdraw benchmark
+        constexpr Nova::Int OVERDRAW_BENCHMARK_DEPTH = 8;
+
+        //Tessellation of the spheres drawn for deferred light volumes
+        constexpr Nova::UInt LIGHT_VOLUME_RINGS = 12;
+        constexpr Nova::UInt LIGHT_VOLUME_SEGMENTS = 16;
     }
 }
 
@@ -0,0 +1,25 @@
+#ifndef CULLING_HPP
+#define CULLING_HPP
+
+#include <Nova/types.hpp>
+
+namespace Nova
+{
+	//Frustum planes as (normal, distance), a point p is inside a plane when dot(normal, p) + distance >= 0
+	struct Frustum
+	{
+		Nova::Vector4 planes[6];
+	};
+
+	//Extracts the normalized planes of the frustum described by an OpenGL style proj * view matrix
+	Nova::Frustum extractFrustum(const Nova::Matrix4& viewProj);
+
+	//Tests spheres stored as (center, radius) against the frustum, 4 or 8 at a time when SIMD is available
+	//Writes the result of each sphere to visible and returns how many passed
+	Nova::UInt cullSpheres(const Nova::Frustum& frustum, const Nova::Vector4* spheres, Nova::UInt count, bool* visible);
+
+	//Bounding sphere of a local space sphere after a model transform
+	Nova::Vector4 transformSphere(const Nova::Matrix4& model, const Nova::Vector3& center, Nova::Float radius);
+}
+
+#endif
\ No newline at end of file
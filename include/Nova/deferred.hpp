@@ -0,0 +1,61 @@
+#ifndef DEFERRED_HPP
+#define DEFERRED_HPP
+
+#include <Nova/types.hpp>
+#include <Nova/structs.hpp>
+
+namespace Nova
+{
+	//GBuffer holds the surface attributes written by the geometry pass
+	class GBuffer
+	{
+	public:
+		GBuffer();
+
+		//Must be called after OpenGL initializes
+		void init(Nova::Int width, Nova::Int height);
+		void destroy();
+
+		//Recreates the attachments when the size changed
+		void resize(Nova::Int width, Nova::Int height);
+
+		Nova::UInt getFramebuffer() const;
+		Nova::UInt getAlbedo() const;
+		Nova::UInt getNormal() const;
+		Nova::UInt getDepth() const;
+
+	private:
+		Nova::UInt framebuffer;
+		Nova::UInt albedo; //RGBA8: surface color
+		Nova::UInt normal; //RGBA16F: world space normal
+		Nova::UInt depth;  //DEPTH24: window depth, positions are rebuilt from it
+
+		Nova::Int width;
+		Nova::Int height;
+
+		void createAttachments();
+		void deleteAttachments();
+	};
+
+	//DeferredRenderer shades point lights from the G-buffer instead of per object
+	//Each light is drawn as a sphere of its influence radius, so only the pixels it covers are shaded
+	class DeferredRenderer
+	{
+	public:
+		//Must be called after OpenGL initializes and the mesh pool exists
+		void init(Nova::Int width, Nova::Int height);
+		void destroy();
+
+		//Binds and clears the G-buffer, the object pass then draws into it
+		void beginGeometryPass();
+
+		//Resolves the G-buffer depth into the default framebuffer and adds every light volume on top
+		void lightingPass();
+
+	private:
+		Nova::GBuffer gBuffer;
+		Nova::MeshInfo volumeMesh;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -7,6 +7,20 @@
 #include "shader.hpp"
 #include "editor_camera.hpp"
 #include "light_manager.hpp"
+#include "gl_state.hpp"
+#include "mesh_pool.hpp"
+#include "stream_buffer.hpp"
+#include "gpu_timer.hpp"
+#include "job_system.hpp"
+#include "deferred.hpp"
+#include "shadows.hpp"
+#include "probe_grid.hpp"
+#include "program_cache.hpp"
+#include "shader_source.hpp"
+#include "texture_array_pool.hpp"
+#include "enums.hpp"
+
+#include <GLFW/glfw3.h>
 
 namespace Nova
 {
@@ -28,6 +42,9 @@ namespace Nova
     //Global store for all textures
     extern Nova::Array<Nova::TextureInfo*> globalTextures;
 
+    //Copies of the textures packed into array pages by size
+    extern Nova::TextureArrayPool textureArrayPool;
+
     //Global store for all meshes
     extern Nova::Array<Nova::MeshInfo> globalMeshes;
 
@@ -37,26 +54,119 @@ namespace Nova
     //The shader to apply editor effects
     extern Nova::Shader forwardShader;
 
+    //Forward shading that reads point lights from the view frustum clusters
+    extern Nova::Shader clusteredShader;
+
     //The shader to apply to light sources
     extern Nova::Shader lightSourceShader;
 
     //The shader for highlighting the active object
     extern Nova::Shader activeObjShader;
 
+    //Forward shading with the normal matrix inverted per vertex, the baseline for the vertex benchmark
+    extern Nova::Shader normalBenchShader;
+
+    //Writes surface attributes into the G-buffer in deferred mode
+    extern Nova::Shader gbufferShader;
+
+    //Copies G-buffer depth to the screen before deferred lights are added
+    extern Nova::Shader deferredResolveShader;
+
+    //Shades one point light over the pixels its volume covers
+    extern Nova::Shader lightVolumeShader;
+
+    //Writes caster depth into the directional shadow maps
+    extern Nova::Shader shadowShader;
+
+    //Writes scene depth before the object pass when the depth pre-pass is on
+    extern Nova::Shader depthPrePassShader;
+
+    //Adds a fixed brightness per shaded fragment to show overdraw
+    extern Nova::Shader overdrawShader;
+
+    //Streamed storage buffer holding the model matrix of every drawn instance
+    extern Nova::StreamBuffer instanceStream;
+
+    //Streamed indirect draw commands for the object pass
+    extern Nova::StreamBuffer indirectStream;
+
+    //Streamed light cluster grid and light index lists
+    extern Nova::StreamBuffer clusterStream;
+
+    //Streamed uniform buffer bound at CONST::SHADOW_DATA_BINDING with the directional light and its cascades
+    extern Nova::StreamBuffer shadowStream;
+
+    //Streamed staging for changed point lights, copied into the light buffer on the GPU
+    extern Nova::StreamBuffer lightStream;
+
+    //Worker threads shared by CPU heavy systems
+    extern Nova::JobSystem jobSystem;
+
+    //Shared vertex and index storage for every mesh
+    extern Nova::MeshPool meshPool;
+
+    //GPU time spent drawing the object pass
+    extern Nova::GPUTimer objectPassTimer;
+
+    //GPU time spent shading light volumes in deferred mode
+    extern Nova::GPUTimer lightingPassTimer;
+
+    //GPU time spent on the depth pre-pass
+    extern Nova::GPUTimer depthPrePassTimer;
+
+    //Samples shaded by the object pass, counts overdraw
+    extern Nova::GPUQuery shadedSamplesQuery;
+
+    //G-buffer and light volume passes used in deferred mode
+    extern Nova::DeferredRenderer deferredRenderer;
+
+    //Cascaded shadow maps of the directional light
+    extern Nova::ShadowMaps shadowMaps;
+
+    //Irradiance probes baked from the static scene, read by forward shading in baked mode
+    extern Nova::ProbeGrid probeGrid;
+
     //The camera that the editor uses, not a part of the final game
     extern Nova::Editor::EditorCamera editorCamera;
 
     //The object to highlight when editing the game
     extern Nova::Entity activeObj;
 
-    //The shader program to use when rendering
-    extern Nova::ShaderProgram activeProgram;
+    //The shader to use when rendering
+    extern Nova::Shader* activeShader;
+
+    //How the object pass is lit, activeShader must match it
+    extern Nova::LightingMode lightingMode;
+
+    //Draws the object pass depth first, then shades only the visible surface of each pixel
+    extern bool depthPrePass;
+
+    //Textured objects sample their texture array page, so objects differing only by texture share draws
+    extern bool textureArrays;
 
     //The lighting manager in charge of all light sources
     extern Nova::Lighting::LightManager lightManager;
 
     //The shader manager to handle recompiles
     extern Nova::ShaderManager shaderManager;
+
+    //Linked program binaries saved between runs, every shader checks it before compiling
+    extern Nova::ProgramCache programCache;
+
+    //Shader files and their expansions with includes resolved, shared by every program
+    extern Nova::ShaderSourceCache shaderSources;
+
+    //Shadow copy of the bound OpenGL state, all binds should go through it
+    extern Nova::GLState glState;
+
+    //Renderer counters for the frame currently being drawn
+    extern Nova::FrameStats frameStats;
+
+    //Camera data computed once per frame, mirrored in frameConstantsStream
+    extern Nova::FrameConstants frameConstants;
+
+    //Streamed uniform buffer bound at CONST::FRAME_CONSTANTS_BINDING for every program
+    extern Nova::StreamBuffer frameConstantsStream;
 }
 
 #endif
\ No newline at end of file
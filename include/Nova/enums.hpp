@@ -8,6 +8,33 @@ namespace Nova
 		DIFFUSE,
 		SPECULAR
 	};
+
+	enum LightingMode
+	{
+		FORWARD,
+		CLUSTERED,
+		UNLIT,
+		DEFERRED,
+		OVERDRAW,
+		BAKED
+	};
+
+	//How ShaderManager builds programs without blocking the editor
+	enum ShaderCompileMode
+	{
+		SYNCHRONOUS,
+		DRIVER_PARALLEL,
+		WORKER_CONTEXTS
+	};
+
+	//Bits of a shader variant's feature mask, each turns into #defines in the variant's source
+	//The object light bucket is stored above these bits, see objectLightFeatures
+	enum ShaderFeature
+	{
+		UNTEXTURED = 1 << 0,
+		BAKED_LIGHTING = 1 << 1,
+		TEXTURE_ARRAY = 1 << 2
+	};
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,59 @@
+#ifndef FILE_WATCHER_HPP
+#define FILE_WATCHER_HPP
+
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <unordered_map>
+
+#include <Nova/types.hpp>
+
+namespace Nova
+{
+	//FileWatcher reports files that changed on disk from a background thread
+	//Linux watches the files' directories with inotify, so files replaced by a rename are caught too
+	//Other platforms compare modification times at CONST::SHADER_WATCH_POLL_MS
+	//A file is only reported once it has been quiet for CONST::SHADER_RELOAD_DEBOUNCE_MS, one save is one report
+	class FileWatcher
+	{
+	public:
+		FileWatcher();
+		~FileWatcher();
+
+		void init();
+		void shutdown();
+
+		//Returns the normalized path changes are reported under, watching a file twice is harmless
+		Nova::String watch(const Nova::String& path);
+
+		//Returns the files whose changes have settled since the last call
+		Nova::Array<Nova::String> takeChanged();
+
+		Nova::UInt getWatchedCount();
+
+	private:
+		typedef std::chrono::steady_clock::time_point TimePoint;
+
+		std::thread thread;
+		std::mutex mutex;
+		std::atomic<bool> running;
+
+		//Watched files with their last modification time, the times are only used when polling
+		std::unordered_map<Nova::String, std::filesystem::file_time_type> files;
+
+		//Changed files by the time of their latest change
+		std::unordered_map<Nova::String, TimePoint> pending;
+
+		//inotify descriptor and the directory of each watch, unused when polling
+		Nova::Int notifyFd;
+		std::unordered_map<Nova::Int, Nova::String> directories;
+
+		void watchLoop();
+		void readEvents();
+		void pollFiles();
+	};
+}
+
+#endif
\ No newline at end of file
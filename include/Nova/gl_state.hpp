@@ -0,0 +1,84 @@
+#ifndef GL_STATE_HPP
+#define GL_STATE_HPP
+
+#include <glad/glad.h>
+
+#include <Nova/types.hpp>
+#include <Nova/const.hpp>
+
+namespace Nova
+{
+	//GLState shadows the bound OpenGL state so redundant calls never reach the driver
+	//All Nova code should bind through it, otherwise the shadow copy goes stale
+	class GLState
+	{
+	public:
+		GLState();
+
+		//Forgets everything, call after code outside Nova touches GL state or objects are deleted
+		void invalidate();
+
+		//Forgets a program about to be deleted, its name may be reused by the next program created
+		void forgetProgram(Nova::UInt program);
+
+		void useProgram(Nova::UInt program);
+		void bindFramebuffer(Nova::UInt framebuffer);
+		void bindVertexArray(Nova::UInt vao);
+		void bindTexture(Nova::UInt unit, Nova::UInt texture);
+		void bindBuffer(GLenum target, Nova::UInt buffer);
+		void bindBufferBase(GLenum target, Nova::UInt index, Nova::UInt buffer);
+
+		//Ranges move every frame when streaming, so they are always issued
+		void bindBufferRange(GLenum target, Nova::UInt index, Nova::UInt buffer, Nova::UInt offset, Nova::UInt size);
+
+		void setDepthTest(bool enabled);
+		void setDepthMask(bool enabled);
+		void setDepthFunc(GLenum func);
+		void setColorMask(bool enabled);
+		void setBlend(bool enabled);
+		void setBlendFunc(GLenum src, GLenum dst);
+		void setCullFace(bool enabled);
+		void setCullFaceMode(GLenum mode);
+		void setPolygonOffset(bool enabled);
+		void setPolygonOffsetParams(Nova::Float factor, Nova::Float units);
+		void setViewport(Nova::Int x, Nova::Int y, Nova::Int width, Nova::Int height);
+
+	private:
+		//Targets that are shadowed, anything else is always issued
+		enum BufferTarget
+		{
+			ARRAY,
+			UNIFORM,
+			SHADER_STORAGE,
+			DRAW_INDIRECT,
+			TARGET_COUNT
+		};
+
+		static constexpr Nova::UInt MAX_BUFFER_BINDINGS = 16;
+
+		//The largest value an unsigned int can hold marks state as unknown
+		static constexpr Nova::UInt UNKNOWN = static_cast<Nova::UInt>(-1);
+
+		Nova::UInt program;
+		Nova::UInt framebuffer;
+		Nova::UInt vao;
+		Nova::UInt textures[Nova::CONST::OPENGL_SHADER_TEXTURE_MAX];
+		Nova::UInt buffers[TARGET_COUNT];
+		Nova::UInt bufferBases[TARGET_COUNT][MAX_BUFFER_BINDINGS];
+
+		Nova::UInt depthTest, depthMask, depthFunc;
+		Nova::UInt colorMask;
+		Nova::UInt blend, blendSrc, blendDst;
+		Nova::UInt cullFace, cullFaceMode;
+		Nova::UInt polygonOffset;
+		Nova::Float polygonOffsetFactor, polygonOffsetUnits;
+		Nova::Int viewport[4];
+
+		static Nova::Int targetIndex(GLenum target);
+
+		//Counts the call, returns true if it has to be issued
+		static bool changed(Nova::UInt& shadow, Nova::UInt value);
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,50 @@
+#ifndef GPU_TIMER_HPP
+#define GPU_TIMER_HPP
+
+#include <glad/glad.h>
+
+#include <Nova/types.hpp>
+#include <Nova/const.hpp>
+
+namespace Nova
+{
+	//GPUQuery measures what the GPU did between begin and end with one kind of query object
+	//Results are read a few frames late so the CPU never waits on the GPU for them
+	//Only one query per target may be running at a time
+	class GPUQuery
+	{
+	public:
+		explicit GPUQuery(GLenum target);
+
+		//Must be called after OpenGL initializes
+		void init();
+		void destroy();
+
+		void begin();
+		void end();
+
+		//Latest finished result in the target's units, e.g. samples for GL_SAMPLES_PASSED
+		Nova::UInt64 getResult() const;
+
+	private:
+		static constexpr Nova::UInt QUERY_COUNT = Nova::CONST::STREAM_BUFFER_REGIONS + 1;
+
+		GLenum target;
+		Nova::UInt queries[QUERY_COUNT];
+		bool pending[QUERY_COUNT];
+		Nova::UInt current;
+		Nova::UInt64 result;
+	};
+
+	//GPUTimer measures GPU time with GL_TIME_ELAPSED queries
+	class GPUTimer : public GPUQuery
+	{
+	public:
+		GPUTimer();
+
+		//Latest finished measurement, in milliseconds
+		Nova::Float getTime() const;
+	};
+}
+
+#endif
\ No newline at end of file
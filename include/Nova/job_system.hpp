@@ -0,0 +1,57 @@
+#ifndef JOB_SYSTEM_HPP
+#define JOB_SYSTEM_HPP
+
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+
+#include <Nova/types.hpp>
+
+namespace Nova
+{
+	//JobSystem keeps a set of worker threads alive and splits loops across them
+	//The calling thread works on the loop too, so a pool with no workers still runs everything
+	class JobSystem
+	{
+	public:
+		JobSystem();
+		~JobSystem();
+
+		//Starts the workers, zero picks one less than the hardware thread count
+		void init(Nova::UInt workerCount = 0);
+		void shutdown();
+
+		//Calls job(begin, end) over chunks of [0, count) and returns once every chunk finished
+		//Chunks may run on any thread in any order, so jobs must only write to their own range
+		void parallelFor(Nova::UInt count, Nova::UInt chunkSize, const std::function<void(Nova::UInt, Nova::UInt)>& job);
+
+		Nova::UInt getThreadCount() const;
+
+	private:
+		Nova::Array<std::thread> workers;
+
+		std::mutex mutex;
+		std::condition_variable wake;
+		std::condition_variable done;
+
+		//The loop currently being run, only written while no worker is active
+		const std::function<void(Nova::UInt, Nova::UInt)>* job;
+		Nova::UInt count;
+		Nova::UInt chunkSize;
+		std::atomic<Nova::UInt> nextChunk;
+
+		//Workers currently inside runChunks, a loop is finished once this drops to zero
+		Nova::UInt activeWorkers;
+		Nova::UInt64 generation;
+		bool stopping;
+
+		void workerLoop();
+
+		//Claims and runs chunks until none are left
+		void runChunks();
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef LIGHT_GRID_HPP
+#define LIGHT_GRID_HPP
+
+#include <unordered_map>
+
+#include <Nova/types.hpp>
+#include <Nova/const.hpp>
+
+namespace Nova
+{
+	//LightGrid is a sparse uniform grid over light spheres, answering which lights touch a region
+	//Lights are identified by their slot, updates only touch the cells a light enters or leaves
+	//Queries never write to the grid, so any number of threads may run them at once
+	class LightGrid
+	{
+	public:
+		LightGrid();
+
+		//Inserts the light or moves it to its new (center, radius)
+		void update(Nova::UInt light, const Nova::Vector4& sphere);
+		void remove(Nova::UInt light);
+
+		//Renames a light, used when slots are compacted, to must not be in the grid
+		void move(Nova::UInt from, Nova::UInt to);
+		void clear();
+
+		//Fill lights with every light whose sphere touches the region, each light appears once
+		void queryAABB(const Nova::Vector3& min, const Nova::Vector3& max, Nova::Array<Nova::UInt>& lights) const;
+		void querySphere(const Nova::Vector4& sphere, Nova::Array<Nova::UInt>& lights) const;
+		void queryFrustum(const Nova::Matrix4& viewProj, Nova::Array<Nova::UInt>& lights) const;
+
+		Nova::UInt getCellCount() const;
+		Nova::UInt getOversizedCount() const;
+
+	private:
+		struct Entry
+		{
+			Nova::Vector4 sphere;
+			Nova::Vector3i cellMin;
+			Nova::Vector3i cellMax;
+			bool inserted = false;
+			bool oversized = false;
+		};
+
+		struct Cell
+		{
+			Nova::Vector3i coords;
+			Nova::Array<Nova::UInt> lights;
+		};
+
+		Nova::Array<Entry> entries;
+		std::unordered_map<Nova::UInt64, Cell> cells;
+
+		//Lights too large for the grid, every query tests them directly
+		Nova::Array<Nova::UInt> oversized;
+
+		Nova::Vector3i cellOf(const Nova::Vector3& point) const;
+		static Nova::UInt64 cellKey(const Nova::Vector3i& cell);
+
+		void link(Nova::UInt light);
+		void unlink(Nova::UInt light);
+
+		//Visits the lights of every occupied cell in the range, each light once, test decides if it is reported
+		template<typename Test>
+		void query(const Nova::Vector3i& rangeMin, const Nova::Vector3i& rangeMax, Test test, Nova::Array<Nova::UInt>& lights) const;
+	};
+}
+
+#endif
\ No newline at end of file
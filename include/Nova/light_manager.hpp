@@ -2,37 +2,91 @@
 #define LIGHT_MANAGER_HPP
 
 #include <vector>
+#include <unordered_map>
 #include <Nova/components.hpp>
 #include <flecs.h>
 #include <Nova/types.hpp>
+#include <Nova/const.hpp>
+#include <Nova/structs.hpp>
+#include <Nova/light_grid.hpp>
 
 namespace Nova
 {
 	namespace Lighting
 	{
+		//LightManager mirrors every point light into one storage buffer bound at CONST::POINT_LIGHT_BINDING
+		//Programs read the lights from the buffer, so there is no per-program state and no light cap
+		//Lights occupy dense slots, changes only mark slots dirty and uploadLights sends them once per frame
+		//Dirty lights are written into lightStream and copied on the GPU, so the CPU never waits for draws still reading the buffer
 		class LightManager
 		{
 		public:
 			LightManager();
 
-			bool addProgram(Nova::ShaderProgram program);
-			void removeProgram(Nova::ShaderProgram program);
-			void clearPrograms();
+			//Must be called after OpenGL initializes
+			void init();
+			void destroy();
 
 			bool addPointLight(Nova::Entity e);
 			bool addPointLight(Nova::Component::PointLight pl);
 			void removePointLight(Nova::String name);
 			void removePointLight(Nova::Entity e);
 
-			void loadPointLight(Nova::Entity e);
+			//Queues the light for the next upload, ignored if the entity is not a managed light
+			void markDirty(Nova::Entity e);
+
+			//Queues every light for the next upload
 			void loadPointLights();
+
+			//Sends dirty slots to the GPU, adjacent slots are merged into one copy
+			void uploadLights();
+
 			void deleteLights();
 
 			Nova::UInt getPointLightCount();
 
+			//World space (center, radius) of every light by slot, as of the last upload
+			const Nova::Array<Nova::Vector4>& getLightBounds() const;
+
+			//Spatial index over the same bounds, answers which slots touch a region without scanning every light
+			const Nova::LightGrid& getLightGrid() const;
+
+			//Fills selected with the slots of the strongest lights reaching a (center, radius) bounds, at most CONST::MAX_OBJECT_LIGHTS
+			//Returns how many lights reached the bounds, safe to call from several threads that each own a candidates list
+			Nova::UInt selectLights(const Nova::Vector4& bounds, Nova::ObjectLights& selected, Nova::Array<Nova::UInt>& candidates) const;
+
+			//Brightness below which a light is treated as having no effect, changing it resizes every light
+			void setAttenuationCutoff(Nova::Float cutoff);
+			Nova::Float getAttenuationCutoff() const;
+
 		private:
-			Nova::Array<Nova::ShaderProgram> programs;
+			//The largest value an unsigned int can hold marks the binding as stale
+			static constexpr Nova::UInt UNBOUND = static_cast<Nova::UInt>(-1);
+
+			Nova::UInt lightBuffer;
+			Nova::UInt capacity;
+			Nova::UInt boundCount;
+
+			//Slot i of the buffer holds pointLights[i], slots maps an entity id back to its slot
 			Nova::Array<Nova::Entity> pointLights;
+			std::unordered_map<Nova::UInt64, Nova::UInt> slots;
+			Nova::Array<Nova::Vector4> lightBounds;
+			Nova::Array<Nova::PointLightData> lightData;
+			Nova::LightGrid lightGrid;
+			Nova::Float cutoff;
+
+			Nova::Array<Nova::UInt> dirtySlots;
+			Nova::Array<bool> dirty;
+
+			Nova::Array<Nova::PointLightData> staging;
+
+			void markSlot(Nova::UInt slot);
+
+			//Stages count lights in lightStream and copies them into the buffer starting at slot first
+			void copyLights(Nova::UInt first, const Nova::PointLightData* lights, Nova::UInt count);
+			void reserve(Nova::UInt count);
+
+			Nova::PointLightData packPointLight(Nova::Entity e) const;
 		};
 	}
 }
@@ -0,0 +1,52 @@
+#ifndef MESH_POOL_HPP
+#define MESH_POOL_HPP
+
+#include <Nova/types.hpp>
+#include <Nova/structs.hpp>
+
+namespace Nova
+{
+	//MeshPool stores every mesh in one shared vertex buffer and index buffer
+	//Meshes are sub-allocated ranges, so they all draw from the same VAO
+	class MeshPool
+	{
+	public:
+		MeshPool();
+
+		//Must be called after OpenGL initializes
+		void init(Nova::UInt vertexCapacity, Nova::UInt indexCapacity);
+		void destroy();
+
+		//Copies the mesh into the pool and fills in the VAO and ranges of meshInfo
+		bool allocate(const Nova::VertexData* vertices, Nova::UInt vertexCount, const Nova::UInt* indices, Nova::UInt indexCount, Nova::MeshInfo& meshInfo);
+		void free(const Nova::MeshInfo& meshInfo);
+
+		Nova::UInt getVAO() const;
+
+	private:
+		//A free span of elements, kept sorted by offset
+		struct Range
+		{
+			Nova::UInt offset;
+			Nova::UInt count;
+		};
+
+		Nova::UInt VAO;
+		Nova::UInt VBO;
+		Nova::UInt EBO;
+
+		Nova::UInt vertexCapacity;
+		Nova::UInt indexCapacity;
+
+		Nova::Array<Range> freeVertices;
+		Nova::Array<Range> freeIndices;
+
+		static bool allocateRange(Nova::Array<Range>& freeList, Nova::UInt count, Nova::UInt& offset);
+		static void releaseRange(Nova::Array<Range>& freeList, Nova::UInt offset, Nova::UInt count);
+
+		//Replaces a buffer with a larger copy, returns the new capacity
+		Nova::UInt grow(Nova::UInt& buffer, Nova::UInt capacity, Nova::UInt required, Nova::UInt elementSize, Nova::Array<Range>& freeList);
+	};
+}
+
+#endif
\ No newline at end of file
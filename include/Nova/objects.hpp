@@ -7,11 +7,20 @@
 namespace Nova
 {
 	Nova::MeshInfo loadCubeMesh();
+	Nova::MeshInfo loadSphereMesh(Nova::UInt rings, Nova::UInt segments);
+
+	//Unit diameter UV sphere centered on the origin
+	void generateSphere(Nova::UInt rings, Nova::UInt segments, Nova::Array<Nova::VertexData>& vertices, Nova::Array<Nova::UInt>& indices);
+
+	//CPU copy of a built in mesh for work done without the mesh pool, returns false for any other name
+	bool generateMesh(const Nova::String& name, Nova::Array<Nova::VertexData>& vertices, Nova::Array<Nova::UInt>& indices);
 
 	Nova::Entity createCube();
+	Nova::Entity createSphere();
 	Nova::Entity createCamera();
 	Nova::Entity createLightCube(const Nova::Component::PointLight& props);
 	Nova::Entity createDefaultPointLight();
+	Nova::Entity createDirectionalLight();
 }
 
 #endif
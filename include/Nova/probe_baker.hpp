@@ -0,0 +1,69 @@
+#ifndef PROBE_BAKER_HPP
+#define PROBE_BAKER_HPP
+
+#include <Nova/types.hpp>
+#include <Nova/const.hpp>
+#include <Nova/structs.hpp>
+#include <Nova/light_grid.hpp>
+#include <Nova/probe_grid.hpp>
+#include <Nova/job_system.hpp>
+
+namespace Nova
+{
+	//ProbeBaker lights a probe grid from static meshes and point lights on the CPU, without OpenGL
+	//Each probe traces a shadow ray to every light that reaches it, the meshes are kept in a BVH for the rays
+	//Probes are independent, so the bake is split across the job system and scales with its threads
+	class ProbeBaker
+	{
+	public:
+		ProbeBaker();
+
+		//Adds a static mesh in world space, only its triangles are used
+		void addMesh(const Nova::Array<Nova::VertexData>& vertices, const Nova::Array<Nova::UInt>& indices, const Nova::Matrix4& model);
+		void addLight(const Nova::PointLightData& light);
+		void clear();
+
+		//Covers the meshes with probes and lights them, returns false and leaves the grid empty if there are no meshes
+		bool bake(Nova::ProbeGrid& grid, Nova::JobSystem& jobs, Nova::Float spacing = Nova::CONST::PROBE_SPACING);
+
+		Nova::UInt getTriangleCount() const;
+		Nova::UInt getLightCount() const;
+
+	private:
+		//Triangles are stored as one corner and two edges, the form the intersection test uses
+		struct Triangle
+		{
+			Nova::Vector3 v0;
+			Nova::Vector3 edge1;
+			Nova::Vector3 edge2;
+		};
+
+		//Leaves hold count triangles from first, inner nodes have count 0 and their right child at first
+		//The left child always follows its parent
+		struct Node
+		{
+			Nova::Vector3 min;
+			Nova::Vector3 max;
+			Nova::UInt first;
+			Nova::UInt count;
+		};
+
+		Nova::Array<Triangle> triangles;
+		Nova::Array<Node> nodes;
+		Nova::Array<Nova::PointLightData> lights;
+
+		//Finds the lights reaching each probe without testing all of them
+		Nova::LightGrid lightGrid;
+
+		void buildBVH();
+		//Splits the triangles listed in order[first, first + count) at the median centroid of their widest axis
+		void buildNode(Nova::UInt node, Nova::UInt first, Nova::UInt count, Nova::Array<Nova::UInt>& order, const Nova::Array<Nova::Vector3>& centroids);
+
+		//True if any triangle blocks the segment between the points, the ends themselves never block
+		bool occluded(const Nova::Vector3& from, const Nova::Vector3& to) const;
+
+		Nova::ProbeData bakeProbe(const Nova::Vector3& position, Nova::Array<Nova::UInt>& candidates) const;
+	};
+}
+
+#endif
\ No newline at end of file
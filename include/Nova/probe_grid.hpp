@@ -0,0 +1,55 @@
+#ifndef PROBE_GRID_HPP
+#define PROBE_GRID_HPP
+
+#include <Nova/types.hpp>
+#include <Nova/const.hpp>
+#include <Nova/structs.hpp>
+
+namespace Nova
+{
+	//ProbeGrid is a regular grid of baked irradiance probes, each storing the light arriving from the six axes
+	//The probes live on the CPU so the grid can be baked, saved and loaded without OpenGL
+	//Uploading copies them into a storage buffer bound at CONST::PROBE_GRID_BINDING, which baked lighting samples
+	class ProbeGrid
+	{
+	public:
+		ProbeGrid();
+
+		//Must be called after OpenGL initializes, binds an empty grid until probes are uploaded
+		void init();
+		void destroy();
+
+		//Places black probes over [min, max], spacing grows if the grid would pass CONST::PROBE_GRID_MAX_DIM on any axis
+		void resize(const Nova::Vector3& min, const Nova::Vector3& max, Nova::Float probeSpacing);
+		void clear();
+
+		//Sends every probe to the storage buffer
+		void upload();
+
+		//The binary file holds the grid layout followed by the probes, returns false if it cannot be read
+		bool save(const Nova::String& filepath) const;
+		bool load(const Nova::String& filepath);
+
+		Nova::Vector3 getProbePosition(Nova::UInt index) const;
+		Nova::UInt getProbeCount() const;
+		Nova::Array<Nova::ProbeData>& getProbes();
+		bool empty() const;
+
+	private:
+		//Matches the header of the std430 ProbeGrid buffer
+		struct Header
+		{
+			Nova::Vector4 origin; //w: spacing
+			Nova::UInt dims[4];
+		};
+
+		Nova::Vector3 origin;
+		Nova::Float spacing;
+		Nova::Vector3i dims;
+		Nova::Array<Nova::ProbeData> probes;
+
+		Nova::UInt buffer;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,51 @@
+#ifndef PROGRAM_CACHE_HPP
+#define PROGRAM_CACHE_HPP
+
+#include <Nova/types.hpp>
+
+namespace Nova
+{
+	//ProgramCache stores linked program binaries on disk so later runs can skip compiling
+	//Keys hash the final shader sources with the driver's vendor, renderer and version, so any change to either misses
+	//Drivers may still reject a binary they wrote, callers then compile from source as on a miss
+	class ProgramCache
+	{
+	public:
+		ProgramCache();
+
+		//Must be called after OpenGL initializes, caching stays off if the driver has no binary formats
+		void init(const Nova::String& directory);
+
+		//Key for a program built from these sources, in stage order
+		Nova::UInt64 makeKey(const Nova::Array<Nova::String>& sources) const;
+
+		//Creates a linked program from the cached binary, returns 0 on a miss or if the driver rejects it
+		Nova::UInt load(Nova::UInt64 key);
+
+		//Programs must be linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set for their binary to be saved
+		void save(Nova::UInt64 key, Nova::UInt program);
+
+		//Counts how a program was created and how long it took, cached or compiled
+		void record(bool cached, Nova::Float milliseconds);
+
+		bool isEnabled() const;
+		Nova::UInt getHits() const;
+		Nova::UInt getMisses() const;
+		Nova::Float getLoadTime() const;
+		Nova::Float getCompileTime() const;
+
+	private:
+		Nova::String directory;
+		Nova::String driver;
+		bool enabled;
+
+		Nova::UInt hits;
+		Nova::UInt misses;
+		Nova::Float loadTime;
+		Nova::Float compileTime;
+
+		Nova::String pathOf(Nova::UInt64 key) const;
+	};
+}
+
+#endif
\ No newline at end of file
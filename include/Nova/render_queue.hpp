@@ -0,0 +1,59 @@
+#ifndef RENDER_QUEUE_HPP
+#define RENDER_QUEUE_HPP
+
+#include <unordered_map>
+
+#include <Nova/types.hpp>
+
+namespace Nova
+{
+	//RenderItem is a single draw, the index refers to per-draw data owned by the pass
+	struct RenderItem
+	{
+		Nova::UInt64 key;
+		Nova::UInt index;
+	};
+
+	//RenderQueue orders the draws of a pass by their sort key before submission
+	//Key layout (high to low): program (8 bits), textures (16 bits), mesh (16 bits), depth (24 bits)
+	//Meshes share the pool VAO, so textures are the more expensive state to change
+	//GL names and pool offsets grow past their fields, so each key stores small ids handed out in order of first use
+	class RenderQueue
+	{
+	public:
+		RenderQueue();
+
+		//Depth should be normalized to [0, 1], smaller values are submitted first
+		//Ids are only valid until the next clear, so keys must not be kept between frames
+		Nova::UInt64 makeKey(Nova::UInt program, Nova::UInt mesh, Nova::UInt textures, Nova::Float depth);
+
+		//Any state bits that differ between keys mean a bind is needed between the two draws
+		static bool sameState(Nova::UInt64 a, Nova::UInt64 b);
+
+		void clear();
+		void push(Nova::UInt64 key, Nova::UInt index);
+
+		//Radix sorts the items by key, returns how many state changes were avoided
+		Nova::UInt sort();
+
+		const Nova::Array<Nova::RenderItem>& getItems() const;
+		Nova::UInt size() const;
+
+	private:
+		Nova::Array<Nova::RenderItem> items;
+		Nova::Array<Nova::RenderItem> scratch;
+
+		//Dense ids of the programs, texture sets and meshes seen since the last clear
+		std::unordered_map<Nova::UInt, Nova::UInt> programIds;
+		std::unordered_map<Nova::UInt, Nova::UInt> textureIds;
+		std::unordered_map<Nova::UInt, Nova::UInt> meshIds;
+		bool overflowReported;
+
+		//Returns the id of value, ids past the field share its last value, which only costs sorting quality
+		Nova::UInt denseId(std::unordered_map<Nova::UInt, Nova::UInt>& ids, Nova::UInt value, Nova::UInt bits);
+
+		Nova::UInt countStateChanges() const;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -1,42 +1,213 @@
 #ifndef SHADER_HPP
 #define SHADER_HPP
 
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
 #include "types.hpp"
 #include "structs.hpp"
+#include "enums.hpp"
+#include "file_watcher.hpp"
+
+struct GLFWwindow;
 
 namespace Nova
 {
+	//FNV-1a hash of a string, constexpr so uniform names can be hashed at compile time
+	constexpr Nova::UInt hashString(const char* str, Nova::UInt hash = 2166136261u)
+	{
+		return (*str == '\0') ? hash : hashString(str + 1, (hash ^ static_cast<Nova::UByte>(*str)) * 16777619u);
+	}
+
+	//A reflected uniform or uniform block, looked up by the hash of its name
+	struct UniformEntry
+	{
+		Nova::UInt hash;
+		Nova::Int location;
+	};
+
+	//Feature bits selecting the forward shader variant unrolled for lightCount point lights
+	Nova::UInt objectLightFeatures(Nova::UInt lightCount);
+
+	//#define lines injected after the #version line, engine constants first and then the variant's features
+	Nova::String shaderDefines(Nova::UInt features);
+
+	//ProgramBuild holds a program while it compiles and links, the program in use is only replaced once it links
+	//Stages are vertex, geometry and fragment, zero when a stage is unused
+	struct ProgramBuild
+	{
+		Nova::UInt program;
+		Nova::UInt stages[3];
+		Nova::String sources[3];
+		Nova::UInt64 cacheKey;
+
+		//Each stage's source hash with its type, stages with equal keys compile to the same shader object
+		Nova::UInt64 stageKeys[3];
+		Nova::Array<Nova::String> stageFiles[3];
+
+		//Shared stages belong to ShaderManager and are released rather than deleted
+		bool sharedStages;
+		std::chrono::steady_clock::time_point start;
+
+		//Set once a worker context has finished the build, unused when the driver compiles in parallel itself
+		std::atomic<bool> done;
+	};
+
 	class Shader
 	{
 	public:
 		//TODO: Implement big three
 		Shader();
 
+		//Start the first build, the program cannot be used until it is ready
 		Nova::Int init(Nova::String vertexFilename, Nova::String fragmentFilename);
 		Nova::Int init(Nova::String vertexFilename, Nova::String geometryFilename, Nova::String fragmentFilename);
+		Nova::Int init(const Nova::ShaderInfo& shaderInfo);
+
+		//Starts building a new program from the files without waiting for it, the current program stays in use meanwhile
+		//Programs in the binary cache are swapped in at once
 		Nova::Int compileShaders();
 
+		//Swaps in the new program once its build finished and linked, a failed build keeps the old program
+		//Returns true if the program changed
+		bool updateBuild();
+
 		~Shader();
 
 		Nova::UInt getProgram(void);
+		const Nova::ShaderInfo& getInfo() const;
+
+		//Every file the program is built from, includes too, a change to any of them rebuilds it
+		Nova::Array<Nova::String> getSourcePaths() const;
+
+		//A shader is ready once any build has linked, and building while a newer program is on the way
+		bool isReady() const;
+		bool isBuilding() const;
+
+		//Returns -1 if the program has no active uniform (or block) with that name
+		Nova::Int getUniformLocation(Nova::UInt nameHash) const;
+		Nova::Int getUniformBlockIndex(Nova::UInt nameHash) const;
+
+		//Setters take pre-hashed names, e.g. setMat4(Nova::hashString("model"), m)
+		void setInt(Nova::UInt nameHash, Nova::Int value);
+		void setFloat(Nova::UInt nameHash, Nova::Float value);
+		void setVec3(Nova::UInt nameHash, const Nova::Vector3& value);
+		void setMat4(Nova::UInt nameHash, const Nova::Matrix4& value);
 
 	private:
 		Nova::UInt program;
 		Nova::ShaderInfo info;
+
+		//Files read by the latest build, normalized
+		Nova::Array<Nova::String> sourceFiles;
+
+		std::shared_ptr<Nova::ProgramBuild> build;
+
+		//Replaces the program in use, deleting the old one
+		void swapProgram(Nova::UInt newProgram);
+
+		//Both tables are sorted by hash for binary search
+		Nova::Array<Nova::UniformEntry> uniforms;
+		Nova::Array<Nova::UniformEntry> uniformBlocks;
+
+		void reflectUniforms();
 	};
 
+	//ShaderManager owns recompiles and variants, and decides how programs are built
+	//Drivers with parallel shader compilation build on their own threads, otherwise hidden windows sharing the
+	//main context give worker threads contexts to build on, so the editor never waits on the compiler
 	class ShaderManager
 	{
 	public:
 		ShaderManager();
 
+		//Must be called after OpenGL initializes and before any shader builds, from the thread owning window
+		void init(GLFWwindow* window);
+		void shutdown();
+
 		bool addShader(Nova::Shader& shader);
+
+		//Queues every shader and variant to rebuild on the next update, each keeps its old program until the new one links
 		void recompileShaders();
 
+		//Rebuilds the shaders whose files changed and swaps in every finished build, called once per frame
+		void update();
+
+		//Blocks until every build has finished, used at startup when nothing can draw yet
+		void waitForBuilds();
+
+		//Returns shader built with the features defined, compiled the first time it is asked for and kept after
+		//Zero features, or a variant still building, returns shader itself
+		//Baked requests instead fall back to the variant with only BAKED_LIGHTING, which must be built up front
+		//Variants are recompiled along with the shaders they come from
+		Nova::Shader& getVariant(Nova::Shader& shader, Nova::UInt features);
+		Nova::UInt getVariantCount() const;
+		Nova::UInt getBuildingCount() const;
+		Nova::ShaderCompileMode getCompileMode() const;
+		Nova::UInt getWatchedFileCount();
+		Nova::UInt getReloadCount() const;
+
+		Nova::UInt getStageReuseCount() const;
+
+		//Used by Shader to start and finish builds in the current mode
+		void submit(const std::shared_ptr<Nova::ProgramBuild>& build);
+		bool isComplete(const Nova::ProgramBuild& build) const;
+		void releaseStages(Nova::ProgramBuild& build);
+
 		Nova::Array<Nova::ShaderProgram> getShaderPrograms();
 
 	private:
 		Nova::Array<std::reference_wrapper<Nova::Shader>> shaders;
+
+		//Variants of each shader by feature mask
+		std::unordered_map<const Nova::Shader*, std::unordered_map<Nova::UInt, std::unique_ptr<Nova::Shader>>> variants;
+
+		Nova::ShaderCompileMode mode;
+
+		//Shaders reading each watched file, by the path the watcher reports it under
+		Nova::FileWatcher watcher;
+		std::unordered_map<Nova::String, Nova::Array<Nova::Shader*>> dependents;
+
+		//Shaders waiting on a rebuild from a file change or a manual recompile, started once their running build is done
+		std::unordered_set<Nova::Shader*> stale;
+		Nova::UInt reloads;
+
+		//Stage objects compiled on this thread, shared by every build in flight with the same stage key
+		//Worker contexts compile their own stages, an object another context is still compiling cannot be used
+		struct StageObject
+		{
+			Nova::UInt shader;
+			Nova::UInt users;
+		};
+
+		std::unordered_map<Nova::UInt64, StageObject> stageObjects;
+		Nova::UInt stageReuses;
+
+		Nova::UInt acquireStage(const Nova::ProgramBuild& build, Nova::UInt stage);
+
+		//Only the shaders not yet tracked for a file are added
+		void track(Nova::Shader& shader);
+
+		//Worker contexts, only used without parallel compilation in the driver
+		Nova::Array<GLFWwindow*> contexts;
+		Nova::Array<std::thread> workers;
+		std::deque<std::shared_ptr<Nova::ProgramBuild>> queue;
+		std::mutex mutex;
+		std::condition_variable wake;
+		bool stopping;
+
+		void workerLoop(GLFWwindow* context);
+
+		//Calls fn on every shader and variant
+		template<typename Fn>
+		void forEachShader(Fn fn);
 	};
 }
 
@@ -0,0 +1,58 @@
+#ifndef SHADER_SOURCE_HPP
+#define SHADER_SOURCE_HPP
+
+#include <unordered_map>
+
+#include <Nova/types.hpp>
+
+namespace Nova
+{
+	//One stage's source with its includes resolved and the engine defines injected
+	struct ShaderSource
+	{
+		Nova::String code;
+		Nova::UInt64 hash;
+
+		//Normalized paths of the file and everything it included, a file's index is its #line source string number
+		Nova::Array<Nova::String> files;
+	};
+
+	//ShaderSourceCache reads shader files once and expands each (file, defines) pair once
+	//#include "path" is resolved relative to the including file, and every file is included at most once per stage
+	//Expanded sources keep #line directives, so compile errors name the source string and line of the file they are in
+	class ShaderSourceCache
+	{
+	public:
+		ShaderSourceCache();
+
+		//Returns the expanded source of path with defines inserted after its #version line
+		//The reference stays valid until the file or one of its includes is invalidated
+		const Nova::ShaderSource& expand(const Nova::String& path, const Nova::String& defines);
+
+		//Drops a file that changed on disk, along with every expansion that read it
+		void invalidate(const Nova::String& path);
+		void clear();
+
+		Nova::UInt getFilesRead() const;
+		Nova::UInt getExpansions() const;
+		Nova::UInt getHits() const;
+
+	private:
+		//File contents by normalized path
+		std::unordered_map<Nova::String, Nova::String> files;
+
+		//Expansions by the hash of their path and defines
+		std::unordered_map<Nova::UInt64, Nova::ShaderSource> expanded;
+
+		Nova::UInt filesRead;
+		Nova::UInt expansions;
+		Nova::UInt hits;
+
+		const Nova::String* readFile(const Nova::String& path);
+
+		//Appends path to source, with the defines after its #version line when it is the stage's root file
+		void expandFile(const Nova::String& path, const Nova::String& defines, Nova::ShaderSource& source);
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,82 @@
+#ifndef SHADOWS_HPP
+#define SHADOWS_HPP
+
+#include <memory>
+
+#include <Nova/types.hpp>
+#include <Nova/const.hpp>
+#include <Nova/structs.hpp>
+
+namespace Nova
+{
+	//ShadowCaster is one object drawn into the shadow maps, only valid while the shadow pass runs
+	struct ShadowCaster
+	{
+		const Nova::Matrix4* model;
+		const Nova::MeshInfo* mesh;
+		bool isStatic;
+	};
+
+	//ShadowMaps renders cascaded shadow maps for one directional light
+	//Static casters are kept in a cached copy of each cascade that is only redrawn when a static changes or the cascade moves
+	//Cascades move in coarse snapped steps, so the caches survive small camera movements
+	class ShadowMaps
+	{
+	public:
+		ShadowMaps();
+
+		//Must be called after OpenGL initializes
+		void init(Nova::Int size);
+		void destroy();
+
+		//Fits each cascade to its slice of the camera frustum, direction is where the light travels
+		void update(const Nova::Matrix4& view, const Nova::Matrix4& proj, Nova::Float zNear, Nova::Float zFar, const Nova::Vector3& direction);
+
+		//Draws every cascade whose casters changed, spheres holds the world bounds of each caster
+		void render(const Nova::Array<Nova::ShadowCaster>& casters, const Nova::Array<Nova::Vector4>& spheres);
+
+		//Called when a static caster moves, appears or disappears
+		void markStaticDirty();
+
+		//Cascade matrices and splits, the light colors are left to the caller
+		const Nova::ShadowData& getData() const;
+		Nova::UInt getTexture() const;
+
+	private:
+		struct Cascade
+		{
+			Nova::Matrix4 viewProj;
+
+			//What the static cache and the final map were last drawn with
+			Nova::Matrix4 staticViewProj;
+			Nova::UInt staticVersion;
+			bool staticValid;
+
+			Nova::Matrix4 renderedViewProj;
+			Nova::UInt renderedStaticVersion;
+			Nova::UInt64 dynamicHash;
+			bool renderedValid;
+		};
+
+		Nova::Int size;
+		Nova::UInt framebuffer;
+		Nova::UInt shadowMap;
+		Nova::UInt staticMap;
+
+		Cascade cascades[Nova::CONST::SHADOW_CASCADES];
+		Nova::ShadowData data;
+
+		//Bumped by every static change, cascades compare it against the version they cached
+		Nova::UInt staticVersion;
+
+		//Culling results, reused between cascades and frames
+		std::unique_ptr<bool[]> visible;
+		Nova::UInt visibleCapacity;
+		Nova::Array<Nova::UInt> staticDraws;
+		Nova::Array<Nova::UInt> dynamicDraws;
+
+		void drawCasters(Nova::UInt texture, Nova::UInt layer, const Nova::Array<Nova::ShadowCaster>& casters, Nova::Array<Nova::UInt>& draws);
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,55 @@
+#ifndef STREAM_BUFFER_HPP
+#define STREAM_BUFFER_HPP
+
+#include <glad/glad.h>
+
+#include <Nova/types.hpp>
+#include <Nova/const.hpp>
+
+namespace Nova
+{
+	//StreamBuffer is a persistently mapped ring for data rewritten every frame
+	//The buffer is split into one region per frame in flight, each guarded by a fence
+	//Allocations are bumped out of the current region and written through the returned pointer
+	class StreamBuffer
+	{
+	public:
+		StreamBuffer();
+
+		//Must be called after OpenGL initializes, alignment is the binding offset alignment of the target
+		void init(Nova::UInt regionSize, Nova::UInt alignment = 1, Nova::UInt regionCount = Nova::CONST::STREAM_BUFFER_REGIONS);
+		void destroy();
+
+		//Moves to the next region, waiting on its fence if the GPU is still reading it
+		void beginFrame();
+
+		//Fences the current region once every command reading it has been submitted
+		void endFrame();
+
+		//Reserves size bytes in the current region, offset is relative to the start of the buffer
+		//Growing replaces the buffer, so finish with a pointer before allocating again
+		void* allocate(Nova::UInt size, Nova::UInt& offset);
+
+		Nova::UInt getBuffer() const;
+		Nova::UInt getAlignment() const;
+
+	private:
+		Nova::UInt buffer;
+		Nova::UByte* mapped;
+
+		Nova::UInt regionSize;
+		Nova::UInt regionCount;
+		Nova::UInt alignment;
+
+		Nova::UInt region;
+		Nova::UInt head;
+
+		Nova::Array<GLsync> fences;
+
+		void create();
+		void release();
+		void waitRegion(Nova::UInt region);
+	};
+}
+
+#endif
\ No newline at end of file
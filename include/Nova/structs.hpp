@@ -4,6 +4,7 @@
 #include <string>
 
 #include <Nova/types.hpp>
+#include <Nova/const.hpp>
 #include <Nova/enums.hpp>
 
 namespace Nova
@@ -17,14 +18,41 @@ namespace Nova
     };
 
     //MeshInfo contains the needed info per mesh
+    //Meshes live in the shared mesh pool, the offsets locate this mesh inside it
     struct MeshInfo
     {
         Nova::UInt VAO;
-        Nova::UInt VBO;
-        Nova::UInt EBO;
+        Nova::UInt baseVertex;
+        Nova::UInt vertexCount;
+        Nova::UInt firstIndex;
         Nova::UInt indexCount;
         Nova::String name;
         Nova::String filepath;
+
+        //Local space bounds, computed when the mesh is loaded
+        Nova::Vector3 boundsMin;
+        Nova::Vector3 boundsMax;
+        Nova::Vector3 sphereCenter;
+        Nova::Float sphereRadius;
+    };
+
+    //DrawElementsIndirectCommand matches the layout glMultiDrawElementsIndirect reads
+    struct DrawElementsIndirectCommand
+    {
+        Nova::UInt count;
+        Nova::UInt instanceCount;
+        Nova::UInt firstIndex;
+        Nova::Int baseVertex;
+        Nova::UInt baseInstance;
+    };
+
+    //InstanceData matches one element of the std430 InstanceData buffer
+    //GLSL pads each mat3 column to a vec4, so the normal matrix keeps a fourth row
+    //The fourth row of the first column holds the texture array layer, the rest of it is unused
+    struct InstanceData
+    {
+        Nova::Matrix4 model;
+        Nova::Matrix43 normal;
     };
 
     struct TextureInfo
@@ -33,6 +61,10 @@ namespace Nova
         Nova::String name;
         Nova::String path;
         Nova::TexType type;
+
+        //Page and layer of the texture's copy in the texture array pool, array is 0 if it was not packed
+        Nova::UInt array;
+        Nova::UInt layer;
     };
 
     struct BaseLight
@@ -42,11 +74,86 @@ namespace Nova
         Nova::Vector3 specular;
     };
 
+    //PointLightData is one element of the std430 PointLights buffer, vec3s are padded to vec4
+    struct PointLightData
+    {
+        Nova::Vector4 position; //w: influence radius
+        Nova::Vector4 ambient;
+        Nova::Vector4 diffuse;
+        Nova::Vector4 specular;
+        Nova::Vector4 attenuation; //x: constant, y: linear, z: quadratic
+    };
+
     struct ShaderInfo
     {
         Nova::String vertexPath;
         Nova::String geometryPath;
         Nova::String fragmentPath;
+        Nova::UInt features; //ShaderFeature bits, zero for the generic program
+    };
+
+    //FrameConstants is the per-frame camera data, laid out to match the std140 FrameConstants block
+    struct FrameConstants
+    {
+        Nova::Matrix4 view;
+        Nova::Matrix4 proj;
+        Nova::Matrix4 viewProj;
+        Nova::Vector4 viewPos;  //xyz: camera position
+        Nova::Vector4 viewport; //x, y, width, height
+        Nova::Vector4 clusterParams; //x: near, y: far, z: depth slice scale, w: depth slice bias
+    };
+
+    //ObjectLights matches one element of the std430 ObjectLightData buffer, the point lights shading one instance
+    struct ObjectLights
+    {
+        Nova::UInt count;
+        Nova::UInt lights[Nova::CONST::MAX_OBJECT_LIGHTS];
+    };
+
+    //ProbeData is one element of the std430 ProbeGrid buffer, the light arriving at a point from each axis
+    //Faces are ordered +X, -X, +Y, -Y, +Z, -Z, w is unused
+    struct ProbeData
+    {
+        Nova::Vector4 cube[6];
+    };
+
+    //ShadowData is the directional light and its cascades, laid out to match the std140 DirectionalLightData block
+    struct ShadowData
+    {
+        Nova::Matrix4 cascadeViewProj[Nova::CONST::SHADOW_CASCADES];
+        Nova::Vector4 cascadeSplits; //View depth at which each cascade ends
+        Nova::Vector4 direction;     //xyz: direction the light travels, w: 1 when a directional light exists
+        Nova::Vector4 ambient;
+        Nova::Vector4 diffuse;
+        Nova::Vector4 specular;
+    };
+
+    //FrameStats collects renderer counters, reset at the start of every frame
+    struct FrameStats
+    {
+        Nova::UInt uniformLookupsSaved;
+        Nova::UInt stateChangesSaved;
+        Nova::UInt objectDrawGroups; //Multi-draw calls in the object pass, one per program and texture set
+        Nova::UInt glCallsIssued;
+        Nova::UInt glCallsSkipped;
+        Nova::UInt objectsDrawn;
+        Nova::UInt objectsCulled;
+        Nova::UInt lightsUploaded;
+        Nova::UInt lightUploads;
+        Nova::UInt clusterLightRefs;
+        Nova::Float clusterBuildTime; //CPU milliseconds spent building light clusters
+        Nova::UInt objectLightCandidates; //Lights the grid returned for all objects, before keeping the strongest
+        Nova::UInt objectLightRefs;
+        Nova::Float lightSelectionTime; //CPU milliseconds spent picking the lights of each object
+        Nova::UInt shadowCascadesRendered;
+        Nova::UInt shadowCascadesSkipped;
+        Nova::UInt shadowStaticRefreshes;
+        Nova::UInt fenceWaits;
+        Nova::Float fenceWaitTime; //Milliseconds the CPU blocked on stream buffer fences
+        Nova::Float objectPassTime; //GPU milliseconds of the object pass, a few frames old
+        Nova::Float depthPrePassTime; //GPU milliseconds of the depth pre-pass, a few frames old
+        Nova::UInt64 samplesShaded; //Samples that passed the depth test in the object pass, a few frames old
+        Nova::Float lightingPassTime; //GPU milliseconds of the deferred lighting pass, a few frames old
     };
 }
 
@@ -3,8 +3,21 @@
 
 #include <flecs.h>
 
+#include <Nova/components.hpp>
+
 namespace Nova
 {
+	void WorldTransformObserver(flecs::entity e, const Nova::Component::Transform& transform);
+	void WorldBoundsObserver(flecs::entity e, const Nova::Component::WorldTransform& transform, const Nova::Component::Mesh& mesh);
+	void PointLightChangeObserver(flecs::entity e, const Nova::Component::Transform& transform, const Nova::Component::PointLight& light);
+	void PointLightRemoveObserver(flecs::entity e, const Nova::Component::PointLight& light);
+	void StaticCasterObserver(flecs::entity e);
+
+	void FrameConstantsSystem(flecs::iter& it);
+	void FrustumCullSystem(flecs::iter& it);
+	void LightUploadSystem(flecs::iter& it);
+	void LightClusterSystem(flecs::iter& it);
+	void DirectionalShadowSystem(flecs::iter& it);
 	void ObjectRenderSystem(flecs::iter& it);
 	void PointLightRenderSystem(flecs::iter& it);
 }
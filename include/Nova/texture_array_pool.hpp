@@ -0,0 +1,52 @@
+#ifndef TEXTURE_ARRAY_POOL_HPP
+#define TEXTURE_ARRAY_POOL_HPP
+
+#include <Nova/types.hpp>
+#include <Nova/structs.hpp>
+
+namespace Nova
+{
+	//TextureArrayPool packs textures of the same size and format into the layers of GL_TEXTURE_2D_ARRAY pages
+	//Objects whose textures share a page bind the same texture, so they can share draws and find their layer per instance
+	//Pages start with one layer and double as textures are added, up to CONST::TEXTURE_ARRAY_LAYERS, a full page starts another one
+	class TextureArrayPool
+	{
+	public:
+		TextureArrayPool();
+
+		//Copies every mip level of the texture's 2D texture into a free layer and records the page and layer in texture
+		//The 2D texture must have a sized internal format and a full mip chain, already packed textures are skipped
+		bool add(Nova::TextureInfo& texture);
+
+		//Packs every texture of the set that is not in a page yet, for when texture arrays are turned on
+		void addAll(const Nova::Array<Nova::TextureInfo*>& textureSet);
+
+		//Deletes every page, the textures packed into them must be deleted as well
+		void clear();
+
+		Nova::UInt getPageCount() const;
+		Nova::UInt getLayerCount() const;
+
+	private:
+		struct Page
+		{
+			Nova::UInt texture;
+			Nova::Int width;
+			Nova::Int height;
+			Nova::UInt internalFormat;
+			Nova::Int levels;
+			Nova::UInt layers;
+			Nova::UInt capacity;
+
+			//Packed textures, so their array name can follow the page when it grows
+			Nova::Array<Nova::TextureInfo*> textures;
+		};
+
+		Nova::Array<Page> pages;
+
+		//Moves the page into a new texture with twice the layers, copying the layers already packed
+		void grow(Page& page);
+	};
+}
+
+#endif
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include <Eigen/Geometry>
 #include <vector>
 #include <string>
+#include <cstdint>
 #include <flecs.h>
 
 namespace Nova
@@ -15,6 +16,7 @@ namespace Nova
 	typedef float Float;
 	typedef char Byte;
 	typedef unsigned char UByte;
+	typedef std::uint64_t UInt64;
 
 	typedef UInt ShaderProgram;
 
@@ -22,7 +24,11 @@ namespace Nova
 
 	typedef Eigen::Vector2f Vector2;
 	typedef Eigen::Vector3f Vector3;
+	typedef Eigen::Vector4f Vector4;
+	typedef Eigen::Vector3i Vector3i;
+	typedef Eigen::Matrix3f Matrix3;
 	typedef Eigen::Matrix4f Matrix4;
+	typedef Eigen::Matrix<float, 4, 3> Matrix43;
 	typedef Eigen::Quaternionf Quaternion;
 	typedef Eigen::Affine3f Affine3;
 	
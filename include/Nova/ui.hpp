@@ -2,6 +2,7 @@
 #define UI_HPP
 
 #include <Nova/types.hpp>
+#include <Nova/structs.hpp>
 
 #include <GLFW/glfw3.h>
 
@@ -14,6 +15,7 @@ namespace Nova
         void MainMenu(GLFWwindow* window, const flecs::world& ecs, Nova::Array<Nova::Entity>& objs);
         void ShowObjectProperties(Nova::Entity& obj);
         void ShowObjectList(Nova::Array<Nova::Entity>& objs, Nova::Entity& activeObj);
+        void ShowStatistics(const Nova::FrameStats& stats);
     }
 }
 
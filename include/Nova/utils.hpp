@@ -19,6 +19,10 @@ namespace Nova
     void processInput(GLFWwindow* window, Nova::Editor::EditorCamera& cam, Nova::Float dt);
     Nova::String readFileToString(Nova::String filename);
 
+    //Absolute path with any . and .. resolved, so two spellings of one file compare equal
+    Nova::String normalizePath(const Nova::String& path);
+
+    void computeMeshBounds(Nova::MeshInfo& mesh, const Nova::VertexData* vertices, Nova::UInt vertexCount);
     Nova::MeshInfo findMesh(const Nova::String& name, const Nova::Array<MeshInfo>& meshes);
     void deleteMeshes(Nova::Array<Nova::MeshInfo>& meshes);
 
@@ -28,13 +32,35 @@ namespace Nova
 
     Nova::Matrix4 lookAt(const Nova::Vector3& position, const Nova::Vector3& target, const Nova::Vector3& up = {0.0f, 1.0f, 0.0f});
     Nova::Matrix4 makePerspective(Nova::Float aspectRatio, Nova::Float fov, Nova::Float near, Nova::Float far);
+    Nova::Matrix4 makeOrthographic(Nova::Float left, Nova::Float right, Nova::Float bottom, Nova::Float top, Nova::Float near, Nova::Float far);
+
+    //64 bit FNV-1a over raw bytes, pass the previous result as hash to continue it over more data
+    Nova::UInt64 hashBytes(const void* bytes, std::size_t count, Nova::UInt64 hash = Nova::CONST::FNV_OFFSET_BASIS);
 
     //This function assumes angles are in degrees, second parameter should be true if already in radians
     Nova::Quaternion rotateFromEuler(Nova::Vector3 angles, bool isRadians = false);
 
+    //Distance at which the light's brightest channel attenuates below cutoff
+    Nova::Float pointLightRadius(const Nova::Component::PointLight& light, Nova::Float cutoff = Nova::CONST::LIGHT_ATTENUATION_CUTOFF);
+
+    //Packs a light placed at position into the layout the shaders read
+    Nova::PointLightData makePointLightData(const Nova::Component::PointLight& light, const Nova::Vector3& position, Nova::Float cutoff = Nova::CONST::LIGHT_ATTENUATION_CUTOFF);
+
+    //Builds the model and normal matrices for a transform
+    Nova::Component::WorldTransform composeTransform(const Nova::Component::Transform& transform);
+
     Nova::Int saveScene(const Nova::String& filepath);
     Nova::Int loadScene(const Nova::String& filepath);
     void clearScene();
+
+    //Baked probes are stored next to the scene file with the extension swapped
+    Nova::String probeFilePath(const Nova::String& scenePath);
+
+    //Bakes the static meshes and point lights of the world into probeGrid and uploads it
+    void bakeProbes();
+
+    //Bakes a saved scene's probes straight to its probe file, needs no window or OpenGL
+    Nova::Int bakeSceneFile(const Nova::String& filepath);
 }
 
 #endif
\ No newline at end of file
@@ -2,7 +2,8 @@
 layout (location = 0) in vec3 inPos;
 
 uniform mat4 model;
-uniform mat4 view;
+
+#include "../include/frame.glsl"
 
 void main()
 {
@@ -0,0 +1,30 @@
+#version 460 core
+layout (location = 0) in vec3 inPos;
+layout (location = 1) in vec3 inNormal;
+layout (location = 2) in vec2 inUV;
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 UV;
+flat out uint InstanceIndex;
+flat out uint TextureLayer;
+
+//Must match the depth pre-pass exactly, the shading pass tests depth for equality
+invariant gl_Position;
+
+#include "../include/frame.glsl"
+#include "../include/instances.glsl"
+
+//Benchmark baseline only, ignores the CPU normal matrix and inverts the model matrix per vertex
+void main()
+{
+   InstanceIndex = gl_BaseInstance + gl_InstanceID;
+   mat4 model = instances[InstanceIndex].model;
+
+   FragPos = vec3(model * vec4(inPos, 1.0));
+   Normal = mat3(transpose(inverse(model))) * inNormal;
+   UV = inUV;
+   TextureLayer = textureLayer(instances[InstanceIndex]);
+
+   gl_Position = viewProj * vec4(FragPos, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+#version 460 core
+
+//-------------DEFINES-------------//
+//CLUSTER_X, CLUSTER_Y, CLUSTER_Z and SHADOW_CASCADES are injected from const.hpp when the program compiles
+
+//-------------INCLUDES-------------//
+//Camera, point lights, and the directional light with its shadows
+#include "include/frame.glsl"
+#include "include/point_lights.glsl"
+#include "include/shadows.glsl"
+#include "include/textures.glsl"
+
+//-------------VARIABLES-------------//
+in vec3 FragPos;
+in vec3 Normal;
+in vec2 UV;
+
+out vec4 FragColor;
+
+//Offset and count of each cluster's lights in lightIndices
+layout (std430, binding = 3) readonly buffer ClusterGrid
+{
+	uvec2 clusters[];
+};
+
+layout (std430, binding = 4) readonly buffer ClusterLightIndices
+{
+	uint lightIndices[];
+};
+
+//Samplers
+uniform sampler2D tex1;
+
+
+//-------------FUNCTIONS-------------//
+vec3 calculatePointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
+{
+	//Find direction of light to the fragment
+	vec3 lightDir = normalize(light.pos.xyz - fragPos);
+
+	//Diffuse intensity
+	float diffVal = max(dot(normal, lightDir), 0.0);
+
+	//Find the ray bouncing off the fragment
+	// vec3 reflectDir = reflect(-lightDir, normal);
+	//Specular intensity
+	//Shine fixed for now
+	// float specVal = pow(max(dot(viewDir, reflectDir), 0.0), 0);
+
+	//Find distance from the light, past the light's radius it adds less than the cutoff
+	float fragDist = length(light.pos.xyz - fragPos);
+	if (fragDist > light.pos.w)
+	{
+		return vec3(0.0);
+	}
+
+	//Attenuation based on distance: 1 / (k + l*d + q*d^2)
+	float attenuation = 1.0 / (light.attenuation.x + light.attenuation.y * fragDist + light.attenuation.z * fragDist * fragDist);
+
+	//Results
+	vec3 ambient = light.ambient.rgb * vec3(sampleTexture(tex1, UV));
+	vec3 diffuse = light.diffuse.rgb * diffVal * vec3(sampleTexture(tex1, UV));
+	//vec3 specular = light.specular * specVal * vec3(texture(tex2, UV));
+
+	return (ambient + diffuse) * attenuation;
+}
+
+
+vec3 calculateDirectionalLight(vec3 normal, vec3 fragPos)
+{
+	vec3 lightDir = normalize(-dirLightDirection.xyz);
+	float diffVal = max(dot(normal, lightDir), 0.0);
+
+	vec3 ambient = dirLightAmbient.rgb * vec3(sampleTexture(tex1, UV));
+	vec3 diffuse = dirLightDiffuse.rgb * diffVal * vec3(sampleTexture(tex1, UV));
+
+	//Ambient light is never shadowed
+	return ambient + diffuse * calculateShadow(fragPos);
+}
+
+
+//Finds the cluster holding this fragment, slices are exponential in view depth
+uint clusterIndex()
+{
+	float depth = -(view * vec4(FragPos, 1.0)).z;
+	uint slice = uint(clamp(floor(log(depth) * clusterParams.z + clusterParams.w), 0.0, CLUSTER_Z - 1));
+
+	uvec2 tile = uvec2(clamp((gl_FragCoord.xy - viewport.xy) / viewport.zw * vec2(CLUSTER_X, CLUSTER_Y), vec2(0.0), vec2(CLUSTER_X - 1, CLUSTER_Y - 1)));
+
+	return tile.x + tile.y * CLUSTER_X + slice * CLUSTER_X * CLUSTER_Y;
+}
+
+void main()
+{
+	vec3 norm = normalize(Normal);
+	vec3 viewDir = normalize(viewPos.xyz - FragPos);
+	vec3 result = vec3(0.0);
+
+	//Run the directional light
+	if (dirLightDirection.w > 0.0)
+	{
+		result += calculateDirectionalLight(norm, FragPos);
+	}
+
+	//Run point lights, only the ones whose radius reaches this fragment's cluster
+	uvec2 cluster = clusters[clusterIndex()];
+	for(uint i = 0; i < cluster.y; ++i)
+	{
+		//Process point lights
+		result += calculatePointLight(pointLights[lightIndices[cluster.x + i]], norm, FragPos, viewDir);
+	}
+
+    //FragColor = texture(tex1, uv);
+    FragColor = vec4(result, 1.0);
+}
\ No newline at end of file
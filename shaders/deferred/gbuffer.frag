@@ -0,0 +1,19 @@
+#version 460 core
+
+//-------------VARIABLES-------------//
+in vec3 FragPos;
+in vec3 Normal;
+in vec2 UV;
+
+layout (location = 0) out vec4 gAlbedo;
+layout (location = 1) out vec4 gNormal;
+
+uniform sampler2D tex0;
+
+#include "../include/textures.glsl"
+
+void main()
+{
+	gAlbedo = sampleTexture(tex0, UV);
+	gNormal = vec4(normalize(Normal), 0.0);
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#version 460 core
+
+//-------------INCLUDES-------------//
+#include "../include/frame.glsl"
+#include "../include/point_lights.glsl"
+
+//-------------VARIABLES-------------//
+flat in uint LightIndex;
+
+out vec4 FragColor;
+
+uniform mat4 invViewProj;
+
+//Samplers
+layout (binding = 0) uniform sampler2D gAlbedo;
+layout (binding = 1) uniform sampler2D gNormal;
+layout (binding = 2) uniform sampler2D gDepth;
+
+
+//-------------FUNCTIONS-------------//
+void main()
+{
+	ivec2 pixel = ivec2(gl_FragCoord.xy);
+	float depth = texelFetch(gDepth, pixel, 0).r;
+
+	if (depth == 1.0)
+	{
+		discard;
+	}
+
+	//Rebuild the world position from the window position and depth
+	vec4 clip = vec4((gl_FragCoord.xy - viewport.xy) / viewport.zw, depth, 1.0) * 2.0 - 1.0;
+	vec4 world = invViewProj * clip;
+	vec3 fragPos = world.xyz / world.w;
+
+	vec3 albedo = texelFetch(gAlbedo, pixel, 0).rgb;
+	vec3 normal = normalize(texelFetch(gNormal, pixel, 0).xyz);
+
+	PointLight light = pointLights[LightIndex];
+
+	//Same model as forward.frag
+	vec3 lightDir = normalize(light.pos.xyz - fragPos);
+	float diffVal = max(dot(normal, lightDir), 0.0);
+
+	float fragDist = length(light.pos.xyz - fragPos);
+	if (fragDist > light.pos.w)
+	{
+		discard;
+	}
+
+	float attenuation = 1.0 / (light.attenuation.x + light.attenuation.y * fragDist + light.attenuation.z * fragDist * fragDist);
+
+	vec3 ambient = light.ambient.rgb * albedo;
+	vec3 diffuse = light.diffuse.rgb * diffVal * albedo;
+
+	FragColor = vec4((ambient + diffuse) * attenuation, 1.0);
+}
\ No newline at end of file
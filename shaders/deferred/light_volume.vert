@@ -0,0 +1,21 @@
+#version 460 core
+layout (location = 0) in vec3 inPos;
+
+#include "../include/frame.glsl"
+#include "../include/point_lights.glsl"
+
+flat out uint LightIndex;
+
+//The volume mesh is a coarse sphere of unit diameter whose faces cut inside the true sphere
+#define VOLUME_SCALE 2.2
+
+void main()
+{
+   PointLight light = pointLights[gl_InstanceID];
+
+   //Lights without falloff have an infinite radius, nothing past the far plane is visible anyway
+   float radius = min(light.pos.w, clusterParams.y);
+
+   LightIndex = gl_InstanceID;
+   gl_Position = viewProj * vec4(light.pos.xyz + inPos * radius * VOLUME_SCALE, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#version 460 core
+
+//-------------INCLUDES-------------//
+//Camera, and the directional light with the same shadow filtering as forward.frag
+#include "../include/frame.glsl"
+#include "../include/shadows.glsl"
+
+//-------------VARIABLES-------------//
+out vec4 FragColor;
+
+uniform mat4 invViewProj;
+
+//Samplers
+layout (binding = 0) uniform sampler2D gAlbedo;
+layout (binding = 1) uniform sampler2D gNormal;
+layout (binding = 2) uniform sampler2D gDepth;
+
+
+//-------------FUNCTIONS-------------//
+void main()
+{
+	ivec2 pixel = ivec2(gl_FragCoord.xy);
+	float depth = texelFetch(gDepth, pixel, 0).r;
+
+	//Nothing was drawn here, keep the clear color
+	if (depth == 1.0)
+	{
+		discard;
+	}
+
+	//Light volumes add onto the directional light and later passes test against the scene depth
+	gl_FragDepth = depth;
+
+	if (dirLightDirection.w == 0.0)
+	{
+		FragColor = vec4(0.0, 0.0, 0.0, 1.0);
+		return;
+	}
+
+	//Rebuild the world position from the window position and depth
+	vec4 clip = vec4((gl_FragCoord.xy - viewport.xy) / viewport.zw, depth, 1.0) * 2.0 - 1.0;
+	vec4 world = invViewProj * clip;
+	vec3 fragPos = world.xyz / world.w;
+
+	vec3 albedo = texelFetch(gAlbedo, pixel, 0).rgb;
+	vec3 normal = normalize(texelFetch(gNormal, pixel, 0).xyz);
+
+	vec3 lightDir = normalize(-dirLightDirection.xyz);
+	float diffVal = max(dot(normal, lightDir), 0.0);
+
+	vec3 ambient = dirLightAmbient.rgb * albedo;
+	vec3 diffuse = dirLightDiffuse.rgb * diffVal * albedo;
+
+	FragColor = vec4(ambient + diffuse * calculateShadow(fragPos), 1.0);
+}
\ No newline at end of file
@@ -1,48 +1,76 @@
 #version 460 core
 
 //-------------DEFINES-------------//
-#define MAX_POINT_LIGHTS 10
-#define MAX_SPOT_LIGHTS  3
+//MAX_OBJECT_LIGHTS and SHADOW_CASCADES are injected from const.hpp when the program compiles
+//Variants also get their features:
+//  UNTEXTURED:               the mesh has no textures, surfaces are white
+//  BAKED_LIGHTING:           point lights come from the baked probes instead of the per-object lists
+//  TEXTURE_ARRAY:            the texture is a layer of a texture array page
+//  OBJECT_LIGHT_COUNT:       the light loop runs this many times and is unrolled
+//  OBJECT_LIGHT_COUNT_EXACT: every object drawn has exactly OBJECT_LIGHT_COUNT lights
+
+//-------------INCLUDES-------------//
+//Camera, point lights, and the directional light with its shadows
+#include "include/frame.glsl"
+#include "include/point_lights.glsl"
+#include "include/shadows.glsl"
+#include "include/textures.glsl"
 
 //-------------STRUCTS-------------//
-struct PointLight
+//Matches Nova::ObjectLights, the strongest point lights reaching one instance
+struct ObjectLights
 {
-	vec3 pos;
-
-	vec3 ambient;
-	vec3 diffuse;
-	vec3 specular;
+	uint count;
+	uint lights[MAX_OBJECT_LIGHTS];
+};
 
-	float constant;
-	float linear;
-	float quadratic;
+//Matches Nova::ProbeData, the light arriving from +X, -X, +Y, -Y, +Z, -Z
+struct Probe
+{
+	vec4 cube[6];
 };
 
 //-------------VARIABLES-------------//
 in vec3 FragPos;
 in vec3 Normal;
 in vec2 UV;
+flat in uint InstanceIndex;
 
 out vec4 FragColor;
 
-//Integers
-uniform int nPointLights;
-
-//Vectors
-uniform vec3 viewPos;
+//Lights chosen on the CPU for each instance, indexed like InstanceData
+layout (std430, binding = 6) readonly buffer ObjectLightData
+{
+	ObjectLights objectLights[];
+};
 
-//Structs
-uniform PointLight pointLights[MAX_POINT_LIGHTS];
+//Baked irradiance probes, read instead of the point lights in baked mode
+layout (std430, binding = 7) readonly buffer ProbeGrid
+{
+	vec4 probeOrigin; //w: spacing
+	uvec4 probeDims;
+	Probe probes[];
+};
 
 //Samplers
 uniform sampler2D tex1;
 
 
 //-------------FUNCTIONS-------------//
+//Surface color, untextured variants are white
+vec3 albedo()
+{
+#ifdef UNTEXTURED
+	return vec3(1.0);
+#else
+	return vec3(sampleTexture(tex1, UV));
+#endif
+}
+
 vec3 calculatePointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
 {
 	//Find direction of light to the fragment
-	vec3 lightDir = normalize(light.pos - fragPos);
+	vec3 lightDir = normalize(light.pos.xyz - fragPos);
 
 	//Diffuse intensity
 	float diffVal = max(dot(normal, lightDir), 0.0);
@@ -53,40 +81,115 @@ vec3 calculatePointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewD
 	//Shine fixed for now
 	// float specVal = pow(max(dot(viewDir, reflectDir), 0.0), 0);
 
-	//Find distance from the light
-	float fragDist = length(light.pos - fragPos);
+	//Find distance from the light, past the light's radius it adds less than the cutoff
+	float fragDist = length(light.pos.xyz - fragPos);
+	if (fragDist > light.pos.w)
+	{
+		return vec3(0.0);
+	}
+
 	//Attenuation based on distance: 1 / (k + l*d + q*d^2)
-	float attenuation = 1.0 / (light.constant + light.linear * fragDist + light.quadratic * fragDist * fragDist);
+	float attenuation = 1.0 / (light.attenuation.x + light.attenuation.y * fragDist + light.attenuation.z * fragDist * fragDist);
 
 	//Results
-	vec3 ambient = light.ambient * vec3(texture(tex1, UV));
-	vec3 diffuse = light.diffuse * diffVal * vec3(texture(tex1, UV));
+	vec3 ambient = light.ambient.rgb * albedo();
+	vec3 diffuse = light.diffuse.rgb * diffVal * albedo();
 	//vec3 specular = light.specular * specVal * vec3(texture(tex2, UV));
 
 	return (ambient + diffuse) * attenuation;
 }
 
 
+vec3 calculateDirectionalLight(vec3 normal, vec3 fragPos)
+{
+	vec3 lightDir = normalize(-dirLightDirection.xyz);
+	float diffVal = max(dot(normal, lightDir), 0.0);
+
+	vec3 ambient = dirLightAmbient.rgb * albedo();
+	vec3 diffuse = dirLightDiffuse.rgb * diffVal * albedo();
+
+	//Ambient light is never shadowed
+	return ambient + diffuse * calculateShadow(fragPos);
+}
+
+
+//Light from the probe's faces, weighted by how much the normal points along each axis
+vec3 sampleProbe(uint index, vec3 normal)
+{
+	vec3 weights = normal * normal;
+	Probe probe = probes[index];
+
+	return weights.x * probe.cube[normal.x < 0.0 ? 1 : 0].rgb
+		+ weights.y * probe.cube[normal.y < 0.0 ? 3 : 2].rgb
+		+ weights.z * probe.cube[normal.z < 0.0 ? 5 : 4].rgb;
+}
+
+//Point light baked into the probe grid, blended between the eight probes around the fragment
+vec3 calculateBakedLight(vec3 normal, vec3 fragPos)
+{
+	if (probeDims.x * probeDims.y * probeDims.z == 0)
+	{
+		return vec3(0.0);
+	}
+
+	//Fragments outside the grid use the probes on its edge
+	vec3 gridPos = clamp((fragPos - probeOrigin.xyz) / probeOrigin.w, vec3(0.0), vec3(probeDims.xyz - 1u));
+	uvec3 base = uvec3(gridPos);
+	vec3 blend = gridPos - vec3(base);
+
+	vec3 irradiance = vec3(0.0);
+	for (uint i = 0u; i < 8u; ++i)
+	{
+		uvec3 offset = uvec3(i & 1u, (i >> 1) & 1u, (i >> 2) & 1u);
+		uvec3 corner = min(base + offset, probeDims.xyz - 1u);
+		vec3 weight = mix(1.0 - blend, blend, vec3(offset));
+
+		irradiance += weight.x * weight.y * weight.z * sampleProbe((corner.z * probeDims.y + corner.y) * probeDims.x + corner.x, normal);
+	}
+
+	return irradiance * albedo();
+}
+
+
 void main()
 {
 	vec3 norm = normalize(Normal);
-	vec3 viewDir = normalize(viewPos - FragPos);
+	vec3 viewDir = normalize(viewPos.xyz - FragPos);
 	vec3 result = vec3(0.0);
 
-	//Run directional lights
-	
-	//TODO: try with dynamic number of point lights
-	//Run point lights
-	for(int i = 0; i < MAX_POINT_LIGHTS; ++i)
+	//Run the directional light
+	if (dirLightDirection.w > 0.0)
+	{
+		result += calculateDirectionalLight(norm, FragPos);
+	}
+
+#if defined(BAKED_LIGHTING)
+	//Static scenes can have their point lights baked, one lookup replaces the light loop
+	result += calculateBakedLight(norm, FragPos);
+#elif defined(OBJECT_LIGHT_COUNT)
+	//The variant knows how many lights to expect, so the loop has a fixed length and unrolls
+	ObjectLights objLights = objectLights[InstanceIndex];
+	for (uint i = 0u; i < OBJECT_LIGHT_COUNT; ++i)
 	{
-		if(i == nPointLights)
+#ifndef OBJECT_LIGHT_COUNT_EXACT
+		if (i >= objLights.count)
 		{
 			break;
 		}
-
+#endif
+		result += calculatePointLight(pointLights[objLights.lights[i]], norm, FragPos, viewDir);
+	}
+#else
+	//Run point lights, only the strongest few reaching this object so the loop stays short with any light count
+	//The count is clamped, a list left over from another mode must not run the loop past the array
+	ObjectLights objLights = objectLights[InstanceIndex];
+	uint lightCount = min(objLights.count, uint(MAX_OBJECT_LIGHTS));
+	for(uint i = 0; i < lightCount; ++i)
+	{
 		//Process point lights
-		result += calculatePointLight(pointLights[i], norm, FragPos, viewDir);
+		result += calculatePointLight(pointLights[objLights.lights[i]], norm, FragPos, viewDir);
 	}
+#endif
 
     //FragColor = texture(tex1, uv);
     FragColor = vec4(result, 1.0);
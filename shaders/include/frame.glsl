@@ -0,0 +1,10 @@
+//Matches Nova::FrameConstants, the camera and viewport of the frame
+layout (std140, binding = 0) uniform FrameConstants
+{
+	mat4 view;
+	mat4 proj;
+	mat4 viewProj;
+	vec4 viewPos;
+	vec4 viewport;
+	vec4 clusterParams; //x: near, y: far, z: depth slice scale, w: depth slice bias
+};
\ No newline at end of file
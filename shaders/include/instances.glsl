@@ -0,0 +1,24 @@
+//The normal matrix is computed once per object on the CPU, use normalMatrix to read it
+//Its columns are padded to vec4, and the padding of the first column holds the texture array layer
+struct Instance
+{
+	mat4 model;
+	mat3x4 normal;
+};
+
+//Matrices of every instance drawn this frame, an indirect command's first instance is gl_BaseInstance
+layout (std430, binding = 1) readonly buffer InstanceData
+{
+	Instance instances[];
+};
+
+mat3 normalMatrix(Instance instance)
+{
+	return mat3(instance.normal);
+}
+
+//Layer of the instance's texture in its texture array page
+uint textureLayer(Instance instance)
+{
+	return uint(instance.normal[0][3]);
+}
\ No newline at end of file
@@ -0,0 +1,17 @@
+//Matches Nova::PointLightData, vec3s are padded to vec4
+struct PointLight
+{
+	vec4 pos; //w: radius where the light falls below the cutoff
+
+	vec4 ambient;
+	vec4 diffuse;
+	vec4 specular;
+
+	vec4 attenuation; //x: constant, y: linear, z: quadratic
+};
+
+//Every point light in the scene, the array length is the light count
+layout (std430, binding = 2) readonly buffer PointLights
+{
+	PointLight pointLights[];
+};
\ No newline at end of file
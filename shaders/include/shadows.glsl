@@ -0,0 +1,48 @@
+//SHADOW_CASCADES is injected from const.hpp when the program compiles
+#include "frame.glsl"
+
+//Matches Nova::ShadowData, the directional light and the cascades of its shadow map
+layout (std140, binding = 5) uniform DirectionalLightData
+{
+	mat4 cascadeViewProj[SHADOW_CASCADES];
+	vec4 cascadeSplits; //View depth at which each cascade ends
+	vec4 dirLightDirection; //xyz: direction the light travels, w: 1 when a directional light exists
+	vec4 dirLightAmbient;
+	vec4 dirLightDiffuse;
+	vec4 dirLightSpecular;
+};
+
+layout (binding = 8) uniform sampler2DArrayShadow shadowMap;
+
+//Fraction of the directional light reaching the fragment, filtered over a 3x3 texel area
+float calculateShadow(vec3 fragPos)
+{
+	float depth = -(view * vec4(fragPos, 1.0)).z;
+
+	//Past the last cascade nothing casts shadows
+	if (depth >= cascadeSplits[SHADOW_CASCADES - 1])
+	{
+		return 1.0;
+	}
+
+	int cascade = 0;
+	while (cascade < SHADOW_CASCADES - 1 && depth > cascadeSplits[cascade])
+	{
+		++cascade;
+	}
+
+	//Cascades are orthographic, so w is always 1
+	vec3 coords = (cascadeViewProj[cascade] * vec4(fragPos, 1.0)).xyz * 0.5 + 0.5;
+	vec2 texel = 1.0 / vec2(textureSize(shadowMap, 0).xy);
+
+	float lit = 0.0;
+	for (int x = -1; x <= 1; ++x)
+	{
+		for (int y = -1; y <= 1; ++y)
+		{
+			lit += texture(shadowMap, vec4(coords.xy + vec2(x, y) * texel, cascade, coords.z));
+		}
+	}
+
+	return lit / 9.0;
+}
\ No newline at end of file
@@ -0,0 +1,17 @@
+//Variants built with TEXTURE_ARRAY read the object's texture from its layer of a texture array page
+#ifdef TEXTURE_ARRAY
+flat in uint TextureLayer;
+
+//Matches CONST::TEXTURE_ARRAY_UNIT
+layout (binding = 9) uniform sampler2DArray textureArray;
+#endif
+
+//The object's texture at uv, tex is only read when the program does not use texture arrays
+vec4 sampleTexture(sampler2D tex, vec2 uv)
+{
+#ifdef TEXTURE_ARRAY
+	return texture(textureArray, vec3(uv, TextureLayer));
+#else
+	return texture(tex, uv);
+#endif
+}
\ No newline at end of file
@@ -2,10 +2,10 @@
 layout (location = 0) in vec3 inPos;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 proj;
+
+#include "../include/frame.glsl"
 
 void main()
 {
-   gl_Position = proj * view * model * vec4(inPos, 1.0);
+   gl_Position = viewProj * model * vec4(inPos, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,11 @@
+#version 460 core
+
+//OVERDRAW_LAYERS is injected from const.hpp when the program compiles
+
+out vec4 FragColor;
+
+//Blending adds every shaded fragment, a pixel turns white after OVERDRAW_LAYERS of them
+void main()
+{
+	FragColor = vec4(vec3(1.0 / OVERDRAW_LAYERS), 1.0);
+}
\ No newline at end of file
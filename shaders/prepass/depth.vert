@@ -0,0 +1,17 @@
+#version 460 core
+layout (location = 0) in vec3 inPos;
+
+#include "../include/frame.glsl"
+
+//Only the model matrix is read
+#include "../include/instances.glsl"
+
+//The shading pass tests depth for equality, so both passes must compute positions the same way
+invariant gl_Position;
+
+void main()
+{
+   vec3 fragPos = vec3(instances[gl_BaseInstance + gl_InstanceID].model * vec4(inPos, 1.0));
+
+   gl_Position = viewProj * vec4(fragPos, 1.0);
+}
\ No newline at end of file
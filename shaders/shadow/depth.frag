@@ -0,0 +1,6 @@
+#version 460 core
+
+//Only depth is written, the rasterizer fills it in
+void main()
+{
+}
\ No newline at end of file
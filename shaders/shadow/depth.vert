@@ -0,0 +1,13 @@
+#version 460 core
+layout (location = 0) in vec3 inPos;
+
+//Only the model matrix is read
+#include "../include/instances.glsl"
+
+//The cascade being drawn
+uniform mat4 lightViewProj;
+
+void main()
+{
+   gl_Position = lightViewProj * instances[gl_BaseInstance + gl_InstanceID].model * vec4(inPos, 1.0);
+}
\ No newline at end of file
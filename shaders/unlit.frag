@@ -9,7 +9,9 @@ out vec4 FragColor;
 
 uniform sampler2D tex0;
 
+#include "include/textures.glsl"
+
 void main()
 {
-	FragColor = texture(tex0, UV);
+	FragColor = sampleTexture(tex0, UV);
 }
\ No newline at end of file
@@ -6,16 +6,25 @@ layout (location = 2) in vec2 inUV;
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 UV;
+flat out uint InstanceIndex;
+flat out uint TextureLayer;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 proj;
+//Must match the depth pre-pass exactly, the shading pass tests depth for equality
+invariant gl_Position;
+
+#include "include/frame.glsl"
+#include "include/instances.glsl"
 
 void main()
 {
-   FragPos = vec3(model * vec4(inPos, 1.0));
-   Normal = mat3(transpose(inverse(model))) * inNormal;
+   //Each indirect command starts at its own base instance
+   InstanceIndex = gl_BaseInstance + gl_InstanceID;
+   Instance instance = instances[InstanceIndex];
+
+   FragPos = vec3(instance.model * vec4(inPos, 1.0));
+   Normal = normalMatrix(instance) * inNormal;
    UV = inUV;
+   TextureLayer = textureLayer(instance);
 
-   gl_Position = proj * view * vec4(FragPos, 1.0);
+   gl_Position = viewProj * vec4(FragPos, 1.0);
 }
\ No newline at end of file
@@ -2,10 +2,11 @@
 #include <Nova/callbacks.hpp>
 
 #include <Nova/editor_camera.hpp>
+#include <Nova/engine.hpp>
 
 void Nova::resizeCB(GLFWwindow* window, int width, int height)
 {
-    glViewport(0, 0, width, height);
+    Nova::glState.setViewport(0, 0, width, height);
 }
 
 //TODO: Stop stutter on mouse reentry to the window
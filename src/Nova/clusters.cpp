@@ -0,0 +1,180 @@
+#include <Nova/clusters.hpp>
+
+#include <cmath>
+#include <algorithm>
+
+static constexpr Nova::UInt CLUSTERS_PER_SLICE = Nova::CONST::CLUSTER_X * Nova::CONST::CLUSTER_Y;
+
+//Maps a clip space coordinate in [-1, 1] to a tile along one axis
+static Nova::UInt tileIndex(Nova::Float ndc, Nova::UInt tiles)
+{
+	Nova::Float tile = std::floor((ndc * 0.5f + 0.5f) * tiles);
+	return static_cast<Nova::UInt>(std::clamp(tile, 0.0f, static_cast<Nova::Float>(tiles - 1)));
+}
+
+static Nova::UInt sliceIndex(Nova::Float depth, const Nova::Vector2& sliceParams)
+{
+	Nova::Float slice = std::floor(std::log(depth) * sliceParams.x() + sliceParams.y());
+	return static_cast<Nova::UInt>(std::clamp(slice, 0.0f, static_cast<Nova::Float>(Nova::CONST::CLUSTER_Z - 1)));
+}
+
+Nova::Vector2 Nova::LightClusters::depthSliceParams(Nova::Float zNear, Nova::Float zFar)
+{
+	Nova::Float logRange = std::log(zFar / zNear);
+	Nova::Float scale = Nova::CONST::CLUSTER_Z / logRange;
+
+	return Nova::Vector2(scale, -std::log(zNear) * scale);
+}
+
+void Nova::LightClusters::build(const Nova::Matrix4& view, const Nova::Matrix4& proj, Nova::Float zNear, Nova::Float zFar,
+	const Nova::Vector4* lights, Nova::UInt lightCount, Nova::JobSystem& jobs)
+{
+	Nova::Vector2 sliceParams = depthSliceParams(zNear, zFar);
+
+	extents.resize(lightCount);
+	sliceIndices.resize(Nova::CONST::CLUSTER_Z);
+	clusters.resize(CLUSTERS_PER_SLICE * Nova::CONST::CLUSTER_Z);
+
+	//Find the block of clusters each light's sphere can touch
+	jobs.parallelFor(lightCount, Nova::CONST::CLUSTER_LIGHTS_PER_JOB, [&](Nova::UInt begin, Nova::UInt end)
+	{
+		for (Nova::UInt i = begin; i < end; ++i)
+		{
+			LightExtent& extent = extents[i];
+			extent = { 1, 0, 1, 0, 1, 0 };
+
+			Nova::Vector4 center = view * Nova::Vector4(lights[i].x(), lights[i].y(), lights[i].z(), 1.0f);
+			Nova::Float radius = lights[i].w();
+			Nova::Float depth = -center.z();
+
+			if (radius <= 0.0f || depth + radius < zNear || depth - radius > zFar)
+			{
+				continue;
+			}
+
+			extent.minZ = sliceIndex(std::max(depth - radius, zNear), sliceParams);
+			extent.maxZ = sliceIndex(std::min(depth + radius, zFar), sliceParams);
+
+			//A sphere reaching behind the near plane can cover any part of the screen
+			if (depth - radius <= zNear)
+			{
+				extent.minX = extent.minY = 0;
+				extent.maxX = Nova::CONST::CLUSTER_X - 1;
+				extent.maxY = Nova::CONST::CLUSTER_Y - 1;
+				continue;
+			}
+
+			//The projected bounding box of the sphere is bounded by its view space box corners
+			Nova::Float minX = 1.0f, maxX = -1.0f, minY = 1.0f, maxY = -1.0f;
+			for (Nova::Float d : { depth - radius, depth + radius })
+			{
+				for (Nova::Float sign : { -1.0f, 1.0f })
+				{
+					Nova::Float x = (proj(0, 0) * (center.x() + sign * radius) - proj(0, 2) * d) / d;
+					Nova::Float y = (proj(1, 1) * (center.y() + sign * radius) - proj(1, 2) * d) / d;
+
+					minX = std::min(minX, x);
+					maxX = std::max(maxX, x);
+					minY = std::min(minY, y);
+					maxY = std::max(maxY, y);
+				}
+			}
+
+			if (maxX < -1.0f || minX > 1.0f || maxY < -1.0f || minY > 1.0f)
+			{
+				continue;
+			}
+
+			extent.minX = tileIndex(minX, Nova::CONST::CLUSTER_X);
+			extent.maxX = tileIndex(maxX, Nova::CONST::CLUSTER_X);
+			extent.minY = tileIndex(minY, Nova::CONST::CLUSTER_Y);
+			extent.maxY = tileIndex(maxY, Nova::CONST::CLUSTER_Y);
+		}
+	});
+
+	//Each slice is built by one thread, lights are visited in slot order so the lists never depend on scheduling
+	jobs.parallelFor(Nova::CONST::CLUSTER_Z, 1, [&](Nova::UInt begin, Nova::UInt end)
+	{
+		for (Nova::UInt z = begin; z < end; ++z)
+		{
+			Nova::ClusterRange* slice = &clusters[z * CLUSTERS_PER_SLICE];
+			Nova::Array<Nova::UInt>& indices = sliceIndices[z];
+
+			for (Nova::UInt i = 0; i < CLUSTERS_PER_SLICE; ++i)
+			{
+				slice[i] = { 0, 0 };
+			}
+
+			//Count first so each cluster gets one contiguous run
+			for (Nova::UInt light = 0; light < lightCount; ++light)
+			{
+				const LightExtent& extent = extents[light];
+				if (z < extent.minZ || z > extent.maxZ || extent.minX > extent.maxX)
+				{
+					continue;
+				}
+
+				for (Nova::UInt y = extent.minY; y <= extent.maxY; ++y)
+				{
+					for (Nova::UInt x = extent.minX; x <= extent.maxX; ++x)
+					{
+						++slice[x + y * Nova::CONST::CLUSTER_X].count;
+					}
+				}
+			}
+
+			Nova::UInt total = 0;
+			for (Nova::UInt i = 0; i < CLUSTERS_PER_SLICE; ++i)
+			{
+				slice[i].offset = total;
+				total += slice[i].count;
+				slice[i].count = 0;
+			}
+
+			indices.resize(total);
+
+			for (Nova::UInt light = 0; light < lightCount; ++light)
+			{
+				const LightExtent& extent = extents[light];
+				if (z < extent.minZ || z > extent.maxZ || extent.minX > extent.maxX)
+				{
+					continue;
+				}
+
+				for (Nova::UInt y = extent.minY; y <= extent.maxY; ++y)
+				{
+					for (Nova::UInt x = extent.minX; x <= extent.maxX; ++x)
+					{
+						Nova::ClusterRange& cluster = slice[x + y * Nova::CONST::CLUSTER_X];
+						indices[cluster.offset + cluster.count++] = light;
+					}
+				}
+			}
+		}
+	});
+
+	//Join the slices into one list, offsets become relative to the whole list
+	lightIndices.clear();
+
+	for (Nova::UInt z = 0; z < Nova::CONST::CLUSTER_Z; ++z)
+	{
+		Nova::UInt base = lightIndices.size();
+
+		for (Nova::UInt i = 0; i < CLUSTERS_PER_SLICE; ++i)
+		{
+			clusters[z * CLUSTERS_PER_SLICE + i].offset += base;
+		}
+
+		lightIndices.insert(lightIndices.end(), sliceIndices[z].begin(), sliceIndices[z].end());
+	}
+}
+
+const Nova::Array<Nova::ClusterRange>& Nova::LightClusters::getClusters() const
+{
+	return clusters;
+}
+
+const Nova::Array<Nova::UInt>& Nova::LightClusters::getLightIndices() const
+{
+	return lightIndices;
+}
\ No newline at end of file
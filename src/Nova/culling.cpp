@@ -0,0 +1,143 @@
+#include <Nova/culling.hpp>
+
+#include <algorithm>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define NOVA_CULL_SSE
+#include <immintrin.h>
+#endif
+
+Nova::Frustum Nova::extractFrustum(const Nova::Matrix4& viewProj)
+{
+	Nova::Frustum frustum;
+
+	//Gribb-Hartmann: each plane is the last row plus or minus one of the others
+	Nova::Vector4 r0 = viewProj.row(0);
+	Nova::Vector4 r1 = viewProj.row(1);
+	Nova::Vector4 r2 = viewProj.row(2);
+	Nova::Vector4 r3 = viewProj.row(3);
+
+	frustum.planes[0] = r3 + r0; //Left
+	frustum.planes[1] = r3 - r0; //Right
+	frustum.planes[2] = r3 + r1; //Bottom
+	frustum.planes[3] = r3 - r1; //Top
+	frustum.planes[4] = r3 + r2; //Near
+	frustum.planes[5] = r3 - r2; //Far
+
+	//Normalize so plane distances are in world units, needed for sphere radii
+	for (auto& plane : frustum.planes)
+	{
+		plane /= plane.head<3>().norm();
+	}
+
+	return frustum;
+}
+
+//Single sphere test, used for the remainder that does not fill a SIMD register
+static bool sphereVisible(const Nova::Frustum& frustum, const Nova::Vector4& sphere)
+{
+	for (const auto& plane : frustum.planes)
+	{
+		if (plane.head<3>().dot(sphere.head<3>()) + plane(3) < -sphere(3))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+Nova::UInt Nova::cullSpheres(const Nova::Frustum& frustum, const Nova::Vector4* spheres, Nova::UInt count, bool* visible)
+{
+	Nova::UInt i = 0;
+	Nova::UInt visibleCount = 0;
+
+#ifdef NOVA_CULL_SSE
+#ifdef __AVX__
+	//Eight spheres per iteration, each plane is broadcast across all lanes
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128 a0 = _mm_loadu_ps(spheres[i + 0].data()), b0 = _mm_loadu_ps(spheres[i + 4].data());
+		__m128 a1 = _mm_loadu_ps(spheres[i + 1].data()), b1 = _mm_loadu_ps(spheres[i + 5].data());
+		__m128 a2 = _mm_loadu_ps(spheres[i + 2].data()), b2 = _mm_loadu_ps(spheres[i + 6].data());
+		__m128 a3 = _mm_loadu_ps(spheres[i + 3].data()), b3 = _mm_loadu_ps(spheres[i + 7].data());
+
+		//Rows become x, y, z, radius of each sphere
+		_MM_TRANSPOSE4_PS(a0, a1, a2, a3);
+		_MM_TRANSPOSE4_PS(b0, b1, b2, b3);
+
+		__m256 x = _mm256_set_m128(b0, a0);
+		__m256 y = _mm256_set_m128(b1, a1);
+		__m256 z = _mm256_set_m128(b2, a2);
+		__m256 negRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_set_m128(b3, a3));
+
+		__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		for (const auto& plane : frustum.planes)
+		{
+			__m256 dist = _mm256_add_ps(
+				_mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(plane(0))), _mm256_mul_ps(y, _mm256_set1_ps(plane(1)))),
+				_mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(plane(2))), _mm256_set1_ps(plane(3))));
+
+			inside = _mm256_and_ps(inside, _mm256_cmp_ps(dist, negRadius, _CMP_GE_OQ));
+		}
+
+		Nova::Int mask = _mm256_movemask_ps(inside);
+		for (Nova::UInt j = 0; j < 8; ++j)
+		{
+			visible[i + j] = (mask >> j) & 1;
+			visibleCount += (mask >> j) & 1;
+		}
+	}
+#endif
+
+	//Four spheres per iteration
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(spheres[i + 0].data());
+		__m128 y = _mm_loadu_ps(spheres[i + 1].data());
+		__m128 z = _mm_loadu_ps(spheres[i + 2].data());
+		__m128 r = _mm_loadu_ps(spheres[i + 3].data());
+
+		//Rows become x, y, z, radius of each sphere
+		_MM_TRANSPOSE4_PS(x, y, z, r);
+		__m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), r);
+
+		__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (const auto& plane : frustum.planes)
+		{
+			__m128 dist = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(plane(0))), _mm_mul_ps(y, _mm_set1_ps(plane(1)))),
+				_mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(plane(2))), _mm_set1_ps(plane(3))));
+
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(dist, negRadius));
+		}
+
+		Nova::Int mask = _mm_movemask_ps(inside);
+		for (Nova::UInt j = 0; j < 4; ++j)
+		{
+			visible[i + j] = (mask >> j) & 1;
+			visibleCount += (mask >> j) & 1;
+		}
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		visible[i] = sphereVisible(frustum, spheres[i]);
+		visibleCount += visible[i];
+	}
+
+	return visibleCount;
+}
+
+Nova::Vector4 Nova::transformSphere(const Nova::Matrix4& model, const Nova::Vector3& center, Nova::Float radius)
+{
+	Nova::Vector4 sphere;
+	sphere.head<3>() = (model * center.homogeneous()).head<3>();
+
+	//Non-uniform scale stretches the sphere, the largest axis keeps it conservative
+	Nova::Float scale = std::max({ model.col(0).head<3>().norm(), model.col(1).head<3>().norm(), model.col(2).head<3>().norm() });
+	sphere(3) = radius * scale;
+
+	return sphere;
+}
\ No newline at end of file
@@ -0,0 +1,194 @@
+#include <Nova/deferred.hpp>
+
+#include <iostream>
+#include <glad/glad.h>
+
+#include <Nova/engine.hpp>
+#include <Nova/objects.hpp>
+
+//Uniform names used by the lighting pass, hashed at compile time
+static constexpr Nova::UInt INV_VIEW_PROJ_HASH = Nova::hashString("invViewProj");
+
+//Texture units the lighting shaders read the G-buffer from
+static constexpr Nova::UInt ALBEDO_UNIT = 0;
+static constexpr Nova::UInt NORMAL_UNIT = 1;
+static constexpr Nova::UInt DEPTH_UNIT = 2;
+
+Nova::GBuffer::GBuffer()
+{
+	framebuffer = albedo = normal = depth = 0;
+	width = height = 0;
+}
+
+void Nova::GBuffer::init(Nova::Int width, Nova::Int height)
+{
+	this->width = width;
+	this->height = height;
+
+	glCreateFramebuffers(1, &framebuffer);
+	createAttachments();
+}
+
+void Nova::GBuffer::destroy()
+{
+	deleteAttachments();
+	glDeleteFramebuffers(1, &framebuffer);
+
+	framebuffer = 0;
+	glState.invalidate();
+}
+
+void Nova::GBuffer::resize(Nova::Int width, Nova::Int height)
+{
+	if ((width == this->width && height == this->height) || width <= 0 || height <= 0)
+	{
+		return;
+	}
+
+	this->width = width;
+	this->height = height;
+
+	deleteAttachments();
+	createAttachments();
+}
+
+void Nova::GBuffer::createAttachments()
+{
+	glCreateTextures(GL_TEXTURE_2D, 1, &albedo);
+	glTextureStorage2D(albedo, 1, GL_RGBA8, width, height);
+
+	glCreateTextures(GL_TEXTURE_2D, 1, &normal);
+	glTextureStorage2D(normal, 1, GL_RGBA16F, width, height);
+
+	glCreateTextures(GL_TEXTURE_2D, 1, &depth);
+	glTextureStorage2D(depth, 1, GL_DEPTH_COMPONENT24, width, height);
+
+	//Pixels map one to one, so nothing is ever filtered
+	for (Nova::UInt texture : { albedo, normal, depth })
+	{
+		glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	}
+
+	glNamedFramebufferTexture(framebuffer, GL_COLOR_ATTACHMENT0, albedo, 0);
+	glNamedFramebufferTexture(framebuffer, GL_COLOR_ATTACHMENT1, normal, 0);
+	glNamedFramebufferTexture(framebuffer, GL_DEPTH_ATTACHMENT, depth, 0);
+
+	const GLenum drawBuffers[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+	glNamedFramebufferDrawBuffers(framebuffer, 2, drawBuffers);
+
+	if (glCheckNamedFramebufferStatus(framebuffer, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+	{
+		std::cerr << "ERROR: G-buffer framebuffer is incomplete." << std::endl;
+	}
+}
+
+void Nova::GBuffer::deleteAttachments()
+{
+	const Nova::UInt textures[] = { albedo, normal, depth };
+	glDeleteTextures(3, textures);
+
+	albedo = normal = depth = 0;
+
+	//Texture names may be handed out again
+	glState.invalidate();
+}
+
+Nova::UInt Nova::GBuffer::getFramebuffer() const
+{
+	return framebuffer;
+}
+
+Nova::UInt Nova::GBuffer::getAlbedo() const
+{
+	return albedo;
+}
+
+Nova::UInt Nova::GBuffer::getNormal() const
+{
+	return normal;
+}
+
+Nova::UInt Nova::GBuffer::getDepth() const
+{
+	return depth;
+}
+
+void Nova::DeferredRenderer::init(Nova::Int width, Nova::Int height)
+{
+	gBuffer.init(width, height);
+
+	//Light volumes only need a rough sphere, the vertex shader enlarges it to cover the true one
+	Nova::Array<Nova::VertexData> vertices;
+	Nova::Array<Nova::UInt> indices;
+	Nova::generateSphere(Nova::CONST::LIGHT_VOLUME_RINGS, Nova::CONST::LIGHT_VOLUME_SEGMENTS, vertices, indices);
+
+	volumeMesh.name = "Light Volume Mesh";
+	meshPool.allocate(vertices.data(), vertices.size(), indices.data(), indices.size(), volumeMesh);
+}
+
+void Nova::DeferredRenderer::destroy()
+{
+	meshPool.free(volumeMesh);
+	gBuffer.destroy();
+}
+
+void Nova::DeferredRenderer::beginGeometryPass()
+{
+	gBuffer.resize(static_cast<Nova::Int>(frameConstants.viewport.z()), static_cast<Nova::Int>(frameConstants.viewport.w()));
+
+	glState.bindFramebuffer(gBuffer.getFramebuffer());
+
+	const Nova::Float clearColor[] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	const Nova::Float clearDepth = 1.0f;
+	glClearNamedFramebufferfv(gBuffer.getFramebuffer(), GL_COLOR, 0, clearColor);
+	glClearNamedFramebufferfv(gBuffer.getFramebuffer(), GL_COLOR, 1, clearColor);
+	glClearNamedFramebufferfv(gBuffer.getFramebuffer(), GL_DEPTH, 0, &clearDepth);
+}
+
+void Nova::DeferredRenderer::lightingPass()
+{
+	lightingPassTimer.begin();
+
+	glState.bindFramebuffer(0);
+	glState.bindTexture(ALBEDO_UNIT, gBuffer.getAlbedo());
+	glState.bindTexture(NORMAL_UNIT, gBuffer.getNormal());
+	glState.bindTexture(DEPTH_UNIT, gBuffer.getDepth());
+
+	//Any VAO works for a full screen triangle, the pool's is usually bound already
+	glState.bindVertexArray(meshPool.getVAO());
+
+	//Copy depth so later forward passes test against the scene, and shade the directional light for the point lights to add onto
+	Nova::Matrix4 invViewProj = frameConstants.viewProj.inverse();
+	glState.setDepthFunc(GL_ALWAYS);
+	glState.setDepthMask(true);
+	glState.useProgram(deferredResolveShader.getProgram());
+	deferredResolveShader.setMat4(INV_VIEW_PROJ_HASH, invViewProj);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+
+	Nova::UInt lightCount = lightManager.getPointLightCount();
+	if (lightCount > 0)
+	{
+		//Back faces behind the scene surface mark the pixels inside a volume, this also works from inside one
+		glState.setDepthFunc(GL_GEQUAL);
+		glState.setDepthMask(false);
+		glState.setCullFace(true);
+		glState.setCullFaceMode(GL_FRONT);
+		glState.setBlend(true);
+		glState.setBlendFunc(GL_ONE, GL_ONE);
+
+		glState.useProgram(lightVolumeShader.getProgram());
+		lightVolumeShader.setMat4(INV_VIEW_PROJ_HASH, invViewProj);
+
+		glDrawElementsInstancedBaseVertex(GL_TRIANGLES, volumeMesh.indexCount, GL_UNSIGNED_INT,
+			(void*)(sizeof(Nova::UInt) * volumeMesh.firstIndex), lightCount, volumeMesh.baseVertex);
+	}
+
+	//Put back the state the forward passes expect
+	glState.setDepthFunc(GL_LESS);
+	glState.setDepthMask(true);
+	glState.setCullFace(false);
+	glState.setBlend(false);
+
+	lightingPassTimer.end();
+}
\ No newline at end of file
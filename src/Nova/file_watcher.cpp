@@ -0,0 +1,197 @@
+#include <Nova/file_watcher.hpp>
+
+#include <iostream>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+#include <Nova/const.hpp>
+#include <Nova/utils.hpp>
+
+Nova::FileWatcher::FileWatcher()
+{
+	running = false;
+	notifyFd = -1;
+}
+
+Nova::FileWatcher::~FileWatcher()
+{
+	shutdown();
+}
+
+void Nova::FileWatcher::init()
+{
+#ifdef __linux__
+	notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (notifyFd < 0)
+	{
+		std::cerr << "WARNING: inotify is unavailable, shader files will be polled instead." << std::endl;
+	}
+#endif
+
+	running = true;
+	thread = std::thread(&Nova::FileWatcher::watchLoop, this);
+}
+
+void Nova::FileWatcher::shutdown()
+{
+	if (!running)
+	{
+		return;
+	}
+
+	running = false;
+	thread.join();
+
+#ifdef __linux__
+	if (notifyFd >= 0)
+	{
+		close(notifyFd);
+		notifyFd = -1;
+	}
+#endif
+
+	std::lock_guard<std::mutex> lock(mutex);
+	files.clear();
+	pending.clear();
+	directories.clear();
+}
+
+Nova::String Nova::FileWatcher::watch(const Nova::String& path)
+{
+	Nova::String key = Nova::normalizePath(path);
+
+	std::lock_guard<std::mutex> lock(mutex);
+	if (files.count(key) > 0)
+	{
+		return key;
+	}
+
+	std::error_code err;
+	files[key] = std::filesystem::last_write_time(key, err);
+
+#ifdef __linux__
+	if (notifyFd >= 0)
+	{
+		//Editors often save by writing a new file and renaming it over the old one, which only the directory sees
+		Nova::String directory = std::filesystem::path(key).parent_path().string();
+		Nova::Int wd = inotify_add_watch(notifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+
+		if (wd < 0)
+		{
+			std::cerr << "WARNING: Could not watch directory: " << directory << std::endl;
+		}
+		else
+		{
+			directories[wd] = directory;
+		}
+	}
+#endif
+
+	return key;
+}
+
+Nova::Array<Nova::String> Nova::FileWatcher::takeChanged()
+{
+	Nova::Array<Nova::String> changed;
+	TimePoint settled = std::chrono::steady_clock::now() - std::chrono::milliseconds(Nova::CONST::SHADER_RELOAD_DEBOUNCE_MS);
+
+	std::lock_guard<std::mutex> lock(mutex);
+	for (auto it = pending.begin(); it != pending.end();)
+	{
+		if (it->second > settled)
+		{
+			++it;
+			continue;
+		}
+
+		changed.push_back(it->first);
+		it = pending.erase(it);
+	}
+
+	return changed;
+}
+
+Nova::UInt Nova::FileWatcher::getWatchedCount()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return static_cast<Nova::UInt>(files.size());
+}
+
+void Nova::FileWatcher::watchLoop()
+{
+	while (running)
+	{
+		if (notifyFd >= 0)
+		{
+			readEvents();
+		}
+		else
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(Nova::CONST::SHADER_WATCH_POLL_MS));
+			pollFiles();
+		}
+	}
+}
+
+void Nova::FileWatcher::readEvents()
+{
+#ifdef __linux__
+	//Waking at the poll interval lets shutdown stop the thread without a signal
+	pollfd fd = { notifyFd, POLLIN, 0 };
+	if (poll(&fd, 1, Nova::CONST::SHADER_WATCH_POLL_MS) <= 0)
+	{
+		return;
+	}
+
+	alignas(inotify_event) char buffer[4096];
+	TimePoint now = std::chrono::steady_clock::now();
+
+	ssize_t length;
+	while ((length = read(notifyFd, buffer, sizeof(buffer))) > 0)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		for (char* ptr = buffer; ptr < buffer + length;)
+		{
+			const inotify_event* event = reinterpret_cast<const inotify_event*>(ptr);
+			ptr += sizeof(inotify_event) + event->len;
+
+			auto directory = directories.find(event->wd);
+			if (event->len == 0 || directory == directories.end())
+			{
+				continue;
+			}
+
+			//Other files in the same directory are ignored, every event pushes the debounce back
+			Nova::String path = (std::filesystem::path(directory->second) / event->name).string();
+			if (files.count(path) > 0)
+			{
+				pending[path] = now;
+			}
+		}
+	}
+#endif
+}
+
+void Nova::FileWatcher::pollFiles()
+{
+	TimePoint now = std::chrono::steady_clock::now();
+
+	std::lock_guard<std::mutex> lock(mutex);
+	for (auto& [path, writeTime] : files)
+	{
+		std::error_code err;
+		auto time = std::filesystem::last_write_time(path, err);
+
+		//A file missing mid-save is caught on a later poll once it is back
+		if (!err && time != writeTime)
+		{
+			writeTime = time;
+			pending[path] = now;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,270 @@
+#include <Nova/gl_state.hpp>
+
+#include <limits>
+
+#include <Nova/engine.hpp>
+
+Nova::GLState::GLState()
+{
+	invalidate();
+}
+
+void Nova::GLState::invalidate()
+{
+	program = UNKNOWN;
+	framebuffer = UNKNOWN;
+	vao = UNKNOWN;
+
+	for (auto& texture : textures)
+	{
+		texture = UNKNOWN;
+	}
+
+	for (Nova::UInt i = 0; i < TARGET_COUNT; ++i)
+	{
+		buffers[i] = UNKNOWN;
+
+		for (auto& base : bufferBases[i])
+		{
+			base = UNKNOWN;
+		}
+	}
+
+	depthTest = depthMask = depthFunc = UNKNOWN;
+	colorMask = UNKNOWN;
+	blend = blendSrc = blendDst = UNKNOWN;
+	cullFace = cullFaceMode = UNKNOWN;
+	polygonOffset = UNKNOWN;
+
+	//NaN never compares equal, so the next offset is always issued
+	polygonOffsetFactor = polygonOffsetUnits = std::numeric_limits<Nova::Float>::quiet_NaN();
+
+	viewport[0] = viewport[1] = viewport[2] = viewport[3] = -1;
+}
+
+void Nova::GLState::forgetProgram(Nova::UInt program)
+{
+	if (this->program == program)
+	{
+		this->program = UNKNOWN;
+	}
+}
+
+Nova::Int Nova::GLState::targetIndex(GLenum target)
+{
+	switch (target)
+	{
+		case GL_ARRAY_BUFFER:
+			return ARRAY;
+		case GL_UNIFORM_BUFFER:
+			return UNIFORM;
+		case GL_SHADER_STORAGE_BUFFER:
+			return SHADER_STORAGE;
+		case GL_DRAW_INDIRECT_BUFFER:
+			return DRAW_INDIRECT;
+		default:
+			//Element buffers belong to the VAO, so they are never shadowed here
+			return -1;
+	}
+}
+
+bool Nova::GLState::changed(Nova::UInt& shadow, Nova::UInt value)
+{
+	if (shadow == value)
+	{
+		++Nova::frameStats.glCallsSkipped;
+		return false;
+	}
+
+	shadow = value;
+	++Nova::frameStats.glCallsIssued;
+	return true;
+}
+
+void Nova::GLState::useProgram(Nova::UInt program)
+{
+	if (changed(this->program, program))
+	{
+		glUseProgram(program);
+	}
+}
+
+void Nova::GLState::bindFramebuffer(Nova::UInt framebuffer)
+{
+	if (changed(this->framebuffer, framebuffer))
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	}
+}
+
+void Nova::GLState::bindVertexArray(Nova::UInt vao)
+{
+	if (changed(this->vao, vao))
+	{
+		glBindVertexArray(vao);
+	}
+}
+
+void Nova::GLState::bindTexture(Nova::UInt unit, Nova::UInt texture)
+{
+	//Binding by unit avoids touching the active texture selector
+	if (unit >= Nova::CONST::OPENGL_SHADER_TEXTURE_MAX || changed(textures[unit], texture))
+	{
+		glBindTextureUnit(unit, texture);
+	}
+}
+
+void Nova::GLState::bindBuffer(GLenum target, Nova::UInt buffer)
+{
+	Nova::Int index = targetIndex(target);
+
+	if (index < 0 || changed(buffers[index], buffer))
+	{
+		glBindBuffer(target, buffer);
+	}
+}
+
+void Nova::GLState::bindBufferBase(GLenum target, Nova::UInt index, Nova::UInt buffer)
+{
+	Nova::Int t = targetIndex(target);
+
+	if (t < 0 || index >= MAX_BUFFER_BINDINGS || changed(bufferBases[t][index], buffer))
+	{
+		//Binding a base also binds the generic target
+		glBindBufferBase(target, index, buffer);
+
+		if (t >= 0)
+		{
+			buffers[t] = buffer;
+		}
+	}
+}
+
+void Nova::GLState::bindBufferRange(GLenum target, Nova::UInt index, Nova::UInt buffer, Nova::UInt offset, Nova::UInt size)
+{
+	Nova::Int t = targetIndex(target);
+
+	++Nova::frameStats.glCallsIssued;
+	glBindBufferRange(target, index, buffer, offset, size);
+
+	if (t >= 0)
+	{
+		//A later whole-buffer bind of the same buffer must not be skipped
+		if (index < MAX_BUFFER_BINDINGS)
+		{
+			bufferBases[t][index] = UNKNOWN;
+		}
+
+		buffers[t] = buffer;
+	}
+}
+
+void Nova::GLState::setDepthTest(bool enabled)
+{
+	if (changed(depthTest, enabled))
+	{
+		enabled ? glEnable(GL_DEPTH_TEST) : glDisable(GL_DEPTH_TEST);
+	}
+}
+
+void Nova::GLState::setDepthMask(bool enabled)
+{
+	if (changed(depthMask, enabled))
+	{
+		glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+	}
+}
+
+void Nova::GLState::setDepthFunc(GLenum func)
+{
+	if (changed(depthFunc, func))
+	{
+		glDepthFunc(func);
+	}
+}
+
+void Nova::GLState::setColorMask(bool enabled)
+{
+	if (changed(colorMask, enabled))
+	{
+		GLboolean mask = enabled ? GL_TRUE : GL_FALSE;
+		glColorMask(mask, mask, mask, mask);
+	}
+}
+
+void Nova::GLState::setBlend(bool enabled)
+{
+	if (changed(blend, enabled))
+	{
+		enabled ? glEnable(GL_BLEND) : glDisable(GL_BLEND);
+	}
+}
+
+void Nova::GLState::setBlendFunc(GLenum src, GLenum dst)
+{
+	//Both factors are one call, so only count it once
+	if (blendSrc == src && blendDst == dst)
+	{
+		++Nova::frameStats.glCallsSkipped;
+		return;
+	}
+
+	blendSrc = src;
+	blendDst = dst;
+	++Nova::frameStats.glCallsIssued;
+	glBlendFunc(src, dst);
+}
+
+void Nova::GLState::setCullFace(bool enabled)
+{
+	if (changed(cullFace, enabled))
+	{
+		enabled ? glEnable(GL_CULL_FACE) : glDisable(GL_CULL_FACE);
+	}
+}
+
+void Nova::GLState::setCullFaceMode(GLenum mode)
+{
+	if (changed(cullFaceMode, mode))
+	{
+		glCullFace(mode);
+	}
+}
+
+void Nova::GLState::setPolygonOffset(bool enabled)
+{
+	if (changed(polygonOffset, enabled))
+	{
+		enabled ? glEnable(GL_POLYGON_OFFSET_FILL) : glDisable(GL_POLYGON_OFFSET_FILL);
+	}
+}
+
+void Nova::GLState::setPolygonOffsetParams(Nova::Float factor, Nova::Float units)
+{
+	if (polygonOffsetFactor == factor && polygonOffsetUnits == units)
+	{
+		++Nova::frameStats.glCallsSkipped;
+		return;
+	}
+
+	polygonOffsetFactor = factor;
+	polygonOffsetUnits = units;
+	++Nova::frameStats.glCallsIssued;
+	glPolygonOffset(factor, units);
+}
+
+void Nova::GLState::setViewport(Nova::Int x, Nova::Int y, Nova::Int width, Nova::Int height)
+{
+	if (viewport[0] == x && viewport[1] == y && viewport[2] == width && viewport[3] == height)
+	{
+		++Nova::frameStats.glCallsSkipped;
+		return;
+	}
+
+	viewport[0] = x;
+	viewport[1] = y;
+	viewport[2] = width;
+	viewport[3] = height;
+	++Nova::frameStats.glCallsIssued;
+	glViewport(x, y, width, height);
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include <Nova/gpu_timer.hpp>
+
+Nova::GPUQuery::GPUQuery(GLenum target)
+{
+	this->target = target;
+
+	for (Nova::UInt i = 0; i < QUERY_COUNT; ++i)
+	{
+		queries[i] = 0;
+		pending[i] = false;
+	}
+
+	current = 0;
+	result = 0;
+}
+
+void Nova::GPUQuery::init()
+{
+	glCreateQueries(target, QUERY_COUNT, queries);
+}
+
+void Nova::GPUQuery::destroy()
+{
+	glDeleteQueries(QUERY_COUNT, queries);
+
+	for (Nova::UInt i = 0; i < QUERY_COUNT; ++i)
+	{
+		queries[i] = 0;
+		pending[i] = false;
+	}
+}
+
+void Nova::GPUQuery::begin()
+{
+	current = (current + 1) % QUERY_COUNT;
+
+	//The oldest query is reused, collect its result first if the GPU has it
+	if (pending[current])
+	{
+		GLint available = GL_FALSE;
+		glGetQueryObjectiv(queries[current], GL_QUERY_RESULT_AVAILABLE, &available);
+
+		if (available)
+		{
+			GLuint64 value = 0;
+			glGetQueryObjectui64v(queries[current], GL_QUERY_RESULT, &value);
+			result = value;
+		}
+
+		pending[current] = false;
+	}
+
+	glBeginQuery(target, queries[current]);
+}
+
+void Nova::GPUQuery::end()
+{
+	glEndQuery(target);
+	pending[current] = true;
+}
+
+Nova::UInt64 Nova::GPUQuery::getResult() const
+{
+	return result;
+}
+
+Nova::GPUTimer::GPUTimer() : GPUQuery(GL_TIME_ELAPSED)
+{
+}
+
+Nova::Float Nova::GPUTimer::getTime() const
+{
+	//Elapsed time is reported in nanoseconds
+	return static_cast<Nova::Float>(getResult()) / 1000000.0f;
+}
\ No newline at end of file
@@ -0,0 +1,131 @@
+#include <Nova/job_system.hpp>
+
+#include <algorithm>
+
+Nova::JobSystem::JobSystem()
+{
+	job = nullptr;
+	count = chunkSize = 0;
+	nextChunk = 0;
+	activeWorkers = 0;
+	generation = 0;
+	stopping = false;
+}
+
+Nova::JobSystem::~JobSystem()
+{
+	shutdown();
+}
+
+void Nova::JobSystem::init(Nova::UInt workerCount)
+{
+	if (workerCount == 0)
+	{
+		Nova::UInt hardware = std::thread::hardware_concurrency();
+		workerCount = hardware > 1 ? hardware - 1 : 0;
+	}
+
+	stopping = false;
+
+	for (Nova::UInt i = 0; i < workerCount; ++i)
+	{
+		workers.emplace_back(&Nova::JobSystem::workerLoop, this);
+	}
+}
+
+void Nova::JobSystem::shutdown()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+
+	for (auto& worker : workers)
+	{
+		worker.join();
+	}
+
+	workers.clear();
+}
+
+Nova::UInt Nova::JobSystem::getThreadCount() const
+{
+	return workers.size() + 1;
+}
+
+void Nova::JobSystem::runChunks()
+{
+	Nova::UInt chunkCount = (count + chunkSize - 1) / chunkSize;
+
+	for (Nova::UInt chunk = nextChunk++; chunk < chunkCount; chunk = nextChunk++)
+	{
+		Nova::UInt begin = chunk * chunkSize;
+		(*job)(begin, std::min(begin + chunkSize, count));
+	}
+}
+
+void Nova::JobSystem::workerLoop()
+{
+	Nova::UInt64 seen = 0;
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [&]() { return stopping || generation != seen; });
+
+			if (stopping)
+			{
+				return;
+			}
+
+			seen = generation;
+			++activeWorkers;
+		}
+
+		runChunks();
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			--activeWorkers;
+		}
+		done.notify_all();
+	}
+}
+
+void Nova::JobSystem::parallelFor(Nova::UInt count, Nova::UInt chunkSize, const std::function<void(Nova::UInt, Nova::UInt)>& job)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	chunkSize = std::max(chunkSize, 1u);
+
+	//Not worth waking anyone for a single chunk
+	if (workers.empty() || count <= chunkSize)
+	{
+		job(0, count);
+		return;
+	}
+
+	{
+		//A worker that woke late for the previous loop may still be reading it
+		std::unique_lock<std::mutex> lock(mutex);
+		done.wait(lock, [&]() { return activeWorkers == 0; });
+
+		this->job = &job;
+		this->count = count;
+		this->chunkSize = chunkSize;
+		nextChunk = 0;
+		++generation;
+	}
+	wake.notify_all();
+
+	runChunks();
+
+	//Every claimed chunk belongs to an active worker, so none left means the loop is finished
+	std::unique_lock<std::mutex> lock(mutex);
+	done.wait(lock, [&]() { return activeWorkers == 0; });
+}
\ No newline at end of file
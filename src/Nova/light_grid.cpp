@@ -0,0 +1,324 @@
+#include <Nova/light_grid.hpp>
+
+#include <algorithm>
+#include <limits>
+
+#include <Nova/culling.hpp>
+
+//Cell coordinates are packed into 21 bits each for the cell key
+static constexpr Nova::Int CELL_LIMIT = 1 << 20;
+
+//Cells in an inclusive range, 64 bit so huge ranges cannot overflow
+static Nova::UInt64 rangeSize(const Nova::Vector3i& min, const Nova::Vector3i& max)
+{
+	return static_cast<Nova::UInt64>(max.x() - min.x() + 1) * static_cast<Nova::UInt64>(max.y() - min.y() + 1)
+		* static_cast<Nova::UInt64>(max.z() - min.z() + 1);
+}
+
+//Swaps the value with the last element and drops it, order does not matter in cell lists
+static void eraseUnordered(Nova::Array<Nova::UInt>& values, Nova::UInt value)
+{
+	auto it = std::find(values.begin(), values.end(), value);
+	if (it != values.end())
+	{
+		*it = values.back();
+		values.pop_back();
+	}
+}
+
+Nova::LightGrid::LightGrid()
+{
+}
+
+Nova::Vector3i Nova::LightGrid::cellOf(const Nova::Vector3& point) const
+{
+	Nova::Vector3 cell = (point / Nova::CONST::LIGHT_GRID_CELL_SIZE).array().floor()
+		.cwiseMax(static_cast<Nova::Float>(-CELL_LIMIT)).cwiseMin(static_cast<Nova::Float>(CELL_LIMIT - 1));
+
+	return cell.cast<Nova::Int>();
+}
+
+Nova::UInt64 Nova::LightGrid::cellKey(const Nova::Vector3i& cell)
+{
+	constexpr Nova::UInt64 mask = (1ull << 21) - 1;
+
+	return (static_cast<Nova::UInt64>(cell.x() + CELL_LIMIT) & mask)
+		| ((static_cast<Nova::UInt64>(cell.y() + CELL_LIMIT) & mask) << 21)
+		| ((static_cast<Nova::UInt64>(cell.z() + CELL_LIMIT) & mask) << 42);
+}
+
+void Nova::LightGrid::update(Nova::UInt light, const Nova::Vector4& sphere)
+{
+	if (light >= entries.size())
+	{
+		entries.resize(light + 1);
+	}
+
+	Entry& entry = entries[light];
+
+	Nova::Vector3 center = sphere.head<3>();
+	Nova::Vector3 extent = Nova::Vector3::Constant(std::max(sphere.w(), 0.0f));
+	Nova::Vector3i cellMin = cellOf(center - extent);
+	Nova::Vector3i cellMax = cellOf(center + extent);
+	bool isOversized = rangeSize(cellMin, cellMax) > Nova::CONST::LIGHT_GRID_MAX_CELLS;
+
+	//Small moves inside the same cells only change the stored sphere
+	if (entry.inserted && entry.oversized == isOversized && (isOversized || (entry.cellMin == cellMin && entry.cellMax == cellMax)))
+	{
+		entry.sphere = sphere;
+		return;
+	}
+
+	if (entry.inserted)
+	{
+		unlink(light);
+	}
+
+	entry.sphere = sphere;
+	entry.cellMin = cellMin;
+	entry.cellMax = cellMax;
+	entry.oversized = isOversized;
+	entry.inserted = true;
+
+	link(light);
+}
+
+void Nova::LightGrid::remove(Nova::UInt light)
+{
+	if (light < entries.size() && entries[light].inserted)
+	{
+		unlink(light);
+		entries[light].inserted = false;
+	}
+}
+
+void Nova::LightGrid::move(Nova::UInt from, Nova::UInt to)
+{
+	if (from >= entries.size() || !entries[from].inserted)
+	{
+		remove(to);
+		return;
+	}
+
+	if (to >= entries.size())
+	{
+		entries.resize(to + 1);
+	}
+
+	remove(to);
+
+	//Rename the light in place, it keeps the same cells
+	Entry& entry = entries[from];
+	if (entry.oversized)
+	{
+		std::replace(oversized.begin(), oversized.end(), from, to);
+	}
+	else
+	{
+		for (Nova::Int z = entry.cellMin.z(); z <= entry.cellMax.z(); ++z)
+		{
+			for (Nova::Int y = entry.cellMin.y(); y <= entry.cellMax.y(); ++y)
+			{
+				for (Nova::Int x = entry.cellMin.x(); x <= entry.cellMax.x(); ++x)
+				{
+					auto& lights = cells[cellKey({ x, y, z })].lights;
+					std::replace(lights.begin(), lights.end(), from, to);
+				}
+			}
+		}
+	}
+
+	entries[to] = entry;
+	entries[from].inserted = false;
+}
+
+void Nova::LightGrid::clear()
+{
+	entries.clear();
+	cells.clear();
+	oversized.clear();
+}
+
+void Nova::LightGrid::link(Nova::UInt light)
+{
+	const Entry& entry = entries[light];
+
+	if (entry.oversized)
+	{
+		oversized.push_back(light);
+		return;
+	}
+
+	for (Nova::Int z = entry.cellMin.z(); z <= entry.cellMax.z(); ++z)
+	{
+		for (Nova::Int y = entry.cellMin.y(); y <= entry.cellMax.y(); ++y)
+		{
+			for (Nova::Int x = entry.cellMin.x(); x <= entry.cellMax.x(); ++x)
+			{
+				Cell& cell = cells[cellKey({ x, y, z })];
+				cell.coords = { x, y, z };
+				cell.lights.push_back(light);
+			}
+		}
+	}
+}
+
+void Nova::LightGrid::unlink(Nova::UInt light)
+{
+	const Entry& entry = entries[light];
+
+	if (entry.oversized)
+	{
+		eraseUnordered(oversized, light);
+		return;
+	}
+
+	for (Nova::Int z = entry.cellMin.z(); z <= entry.cellMax.z(); ++z)
+	{
+		for (Nova::Int y = entry.cellMin.y(); y <= entry.cellMax.y(); ++y)
+		{
+			for (Nova::Int x = entry.cellMin.x(); x <= entry.cellMax.x(); ++x)
+			{
+				auto it = cells.find(cellKey({ x, y, z }));
+				if (it == cells.end())
+				{
+					continue;
+				}
+
+				//Empty cells are dropped so the map only holds occupied space
+				eraseUnordered(it->second.lights, light);
+				if (it->second.lights.empty())
+				{
+					cells.erase(it);
+				}
+			}
+		}
+	}
+}
+
+template<typename Test>
+void Nova::LightGrid::query(const Nova::Vector3i& rangeMin, const Nova::Vector3i& rangeMax, Test test, Nova::Array<Nova::UInt>& lights) const
+{
+	lights.clear();
+
+	for (Nova::UInt light : oversized)
+	{
+		if (test(entries[light].sphere))
+		{
+			lights.push_back(light);
+		}
+	}
+
+	//A light in several cells of the range is only reported from the first cell both share
+	auto visit = [&](const Cell& cell)
+	{
+		for (Nova::UInt light : cell.lights)
+		{
+			const Entry& entry = entries[light];
+			if (cell.coords == entry.cellMin.cwiseMax(rangeMin) && test(entry.sphere))
+			{
+				lights.push_back(light);
+			}
+		}
+	};
+
+	//Walk whichever is smaller, the cells of the range or the occupied cells
+	if (rangeSize(rangeMin, rangeMax) <= cells.size())
+	{
+		for (Nova::Int z = rangeMin.z(); z <= rangeMax.z(); ++z)
+		{
+			for (Nova::Int y = rangeMin.y(); y <= rangeMax.y(); ++y)
+			{
+				for (Nova::Int x = rangeMin.x(); x <= rangeMax.x(); ++x)
+				{
+					auto it = cells.find(cellKey({ x, y, z }));
+					if (it != cells.end())
+					{
+						visit(it->second);
+					}
+				}
+			}
+		}
+	}
+	else
+	{
+		for (const auto& [key, cell] : cells)
+		{
+			if ((cell.coords.array() >= rangeMin.array()).all() && (cell.coords.array() <= rangeMax.array()).all())
+			{
+				visit(cell);
+			}
+		}
+	}
+}
+
+void Nova::LightGrid::queryAABB(const Nova::Vector3& min, const Nova::Vector3& max, Nova::Array<Nova::UInt>& lights) const
+{
+	query(cellOf(min), cellOf(max), [&min, &max](const Nova::Vector4& sphere)
+	{
+		//Distance from the center to the closest point of the box
+		Nova::Vector3 closest = sphere.head<3>().cwiseMax(min).cwiseMin(max);
+		return (closest - sphere.head<3>()).squaredNorm() <= sphere.w() * sphere.w();
+	}, lights);
+}
+
+void Nova::LightGrid::querySphere(const Nova::Vector4& sphere, Nova::Array<Nova::UInt>& lights) const
+{
+	Nova::Vector3 center = sphere.head<3>();
+	Nova::Vector3 extent = Nova::Vector3::Constant(sphere.w());
+
+	query(cellOf(center - extent), cellOf(center + extent), [&sphere](const Nova::Vector4& light)
+	{
+		Nova::Float reach = light.w() + sphere.w();
+		return (light.head<3>() - sphere.head<3>()).squaredNorm() <= reach * reach;
+	}, lights);
+}
+
+void Nova::LightGrid::queryFrustum(const Nova::Matrix4& viewProj, Nova::Array<Nova::UInt>& lights) const
+{
+	Nova::Frustum frustum = Nova::extractFrustum(viewProj);
+
+	//The frustum's corners bound the cells that can hold a visible light
+	Nova::Matrix4 invViewProj = viewProj.inverse();
+	Nova::Vector3 min = Nova::Vector3::Constant(std::numeric_limits<Nova::Float>::max());
+	Nova::Vector3 max = -min;
+
+	for (Nova::UInt i = 0; i < 8; ++i)
+	{
+		Nova::Vector4 corner = invViewProj * Nova::Vector4((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f, 1.0f);
+		Nova::Vector3 point = corner.head<3>() / corner.w();
+
+		min = min.cwiseMin(point);
+		max = max.cwiseMax(point);
+	}
+
+	//The box also rejects spheres near the frustum's corners that the planes alone let through
+	query(cellOf(min), cellOf(max), [&frustum, &min, &max](const Nova::Vector4& sphere)
+	{
+		Nova::Vector3 closest = sphere.head<3>().cwiseMax(min).cwiseMin(max);
+		if ((closest - sphere.head<3>()).squaredNorm() > sphere.w() * sphere.w())
+		{
+			return false;
+		}
+
+		for (const auto& plane : frustum.planes)
+		{
+			if (plane.head<3>().dot(sphere.head<3>()) + plane.w() < -sphere.w())
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}, lights);
+}
+
+Nova::UInt Nova::LightGrid::getCellCount() const
+{
+	return cells.size();
+}
+
+Nova::UInt Nova::LightGrid::getOversizedCount() const
+{
+	return oversized.size();
+}
\ No newline at end of file
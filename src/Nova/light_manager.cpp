@@ -1,28 +1,36 @@
 #include <Nova/light_manager.hpp>
 
 #include <iostream>
+#include <algorithm>
+#include <cstring>
 #include <glad/glad.h>
 
+#include <Nova/engine.hpp>
+#include <Nova/utils.hpp>
+
 Nova::Lighting::LightManager::LightManager()
 {
+	lightBuffer = 0;
+	capacity = 0;
+	boundCount = UNBOUND;
+	cutoff = Nova::CONST::LIGHT_ATTENUATION_CUTOFF;
 }
 
-bool Nova::Lighting::LightManager::addProgram(Nova::ShaderProgram program)
+void Nova::Lighting::LightManager::init()
 {
-	programs.push_back(program);
-
-	loadPointLights();
+	glCreateBuffers(1, &lightBuffer);
 
-	return true;
+	reserve(1);
+	uploadLights();
 }
 
-void Nova::Lighting::LightManager::removeProgram(Nova::ShaderProgram program)
+void Nova::Lighting::LightManager::destroy()
 {
-}
+	glDeleteBuffers(1, &lightBuffer);
 
-void Nova::Lighting::LightManager::clearPrograms()
-{
-	programs.clear();
+	lightBuffer = 0;
+	capacity = 0;
+	boundCount = UNBOUND;
 }
 
 bool Nova::Lighting::LightManager::addPointLight(Nova::Entity e)
@@ -33,9 +41,20 @@ bool Nova::Lighting::LightManager::addPointLight(Nova::Entity e)
 		return false;
 	}
 
+	if (slots.count(e.id()))
+	{
+		return true;
+	}
+
+	//New lights always take the slot after the last one
+	Nova::UInt slot = pointLights.size();
+	slots[e.id()] = slot;
 	pointLights.push_back(e);
-	
-	loadPointLights();
+	lightBounds.push_back(Nova::Vector4::Zero());
+	lightData.emplace_back();
+	dirty.push_back(false);
+
+	markSlot(slot);
 
 	return true;
 }
@@ -47,35 +66,161 @@ bool Nova::Lighting::LightManager::addPointLight(Nova::Component::PointLight pl)
 
 void Nova::Lighting::LightManager::removePointLight(Nova::String name)
 {
+	auto it = std::find_if(pointLights.begin(), pointLights.end(),
+		[&name](Nova::Entity e) { const char* n = e.doc_name(); return n != nullptr && name == n; });
+
+	if (it != pointLights.end())
+	{
+		removePointLight(*it);
+	}
 }
 
 void Nova::Lighting::LightManager::removePointLight(Nova::Entity e)
 {
+	auto it = slots.find(e.id());
+
+	if (it == slots.end())
+	{
+		return;
+	}
+
+	Nova::UInt slot = it->second;
+	Nova::UInt last = pointLights.size() - 1;
+	slots.erase(it);
+	lightGrid.remove(slot);
+
+	//The last light moves into the hole so slots stay dense
+	if (slot != last)
+	{
+		pointLights[slot] = pointLights[last];
+		lightBounds[slot] = lightBounds[last];
+		lightData[slot] = lightData[last];
+		lightGrid.move(last, slot);
+		slots[pointLights[slot].id()] = slot;
+		markSlot(slot);
+	}
+
+	pointLights.pop_back();
+	lightBounds.pop_back();
+	lightData.pop_back();
+	dirty.pop_back();
+
+	//A dirty entry past the end has nothing left to upload
+	dirtySlots.erase(std::remove(dirtySlots.begin(), dirtySlots.end(), last), dirtySlots.end());
+}
+
+void Nova::Lighting::LightManager::markDirty(Nova::Entity e)
+{
+	auto it = slots.find(e.id());
+
+	if (it != slots.end())
+	{
+		markSlot(it->second);
+	}
+}
+
+void Nova::Lighting::LightManager::markSlot(Nova::UInt slot)
+{
+	if (!dirty[slot])
+	{
+		dirty[slot] = true;
+		dirtySlots.push_back(slot);
+	}
+}
+
+void Nova::Lighting::LightManager::reserve(Nova::UInt count)
+{
+	if (count <= capacity)
+	{
+		return;
+	}
+
+	//Storage only grows, and doubling keeps adding lights one at a time cheap
+	capacity = std::max(count, capacity * 2);
+	glNamedBufferData(lightBuffer, sizeof(Nova::PointLightData) * capacity, NULL, GL_DYNAMIC_DRAW);
+
+	//The old contents are gone, every light must be sent again and the range rebound
+	loadPointLights();
+	boundCount = UNBOUND;
+}
+
+Nova::PointLightData Nova::Lighting::LightManager::packPointLight(Nova::Entity e) const
+{
+	return Nova::makePointLightData(*e.get<Nova::Component::PointLight>(), e.get<Nova::Component::Transform>()->position, cutoff);
+}
+
+void Nova::Lighting::LightManager::loadPointLights()
+{
+	for (Nova::UInt i = 0; i < pointLights.size(); ++i)
+	{
+		markSlot(i);
+	}
 }
 
-void Nova::Lighting::LightManager::loadPointLight(Nova::Entity e)
+void Nova::Lighting::LightManager::uploadLights()
 {
-	//Get the index of the point light in the array, and the point light info
-	auto i = std::distance(pointLights.begin(), std::find(pointLights.begin(), pointLights.end(), e));
-	auto plInfo = e.get<Nova::Component::PointLight>();
-	auto transform = e.get<Nova::Component::Transform>();
+	Nova::UInt count = pointLights.size();
+	reserve(std::max(count, 1u));
+
+	std::sort(dirtySlots.begin(), dirtySlots.end());
+
+	//Each run of consecutive dirty slots becomes one upload
+	for (Nova::UInt i = 0; i < dirtySlots.size();)
+	{
+		Nova::UInt first = dirtySlots[i];
+		Nova::UInt end = i;
+
+		staging.clear();
+		while (end < dirtySlots.size() && dirtySlots[end] == first + (end - i))
+		{
+			staging.push_back(packPointLight(pointLights[dirtySlots[end]]));
+			lightBounds[dirtySlots[end]] = staging.back().position;
+			lightData[dirtySlots[end]] = staging.back();
+			lightGrid.update(dirtySlots[end], staging.back().position);
+			dirty[dirtySlots[end]] = false;
+			++end;
+		}
+
+		copyLights(first, staging.data(), staging.size());
+
+		frameStats.lightsUploaded += staging.size();
+		++frameStats.lightUploads;
 
-	std::string str = "pointLights[";
-	str += std::to_string(i);
-	str += "].";
+		i = end;
+	}
+
+	dirtySlots.clear();
 
-	for (auto program : programs)
+	if (count == boundCount)
 	{
-		glProgramUniform3fv(program, glGetUniformLocation(program, (str + "pos").c_str()), 1, transform->position.data());
+		return;
+	}
 
-		glProgramUniform3fv(program, glGetUniformLocation(program, (str + "ambient").c_str()), 1, plInfo->base.ambient.data());
-		glProgramUniform3fv(program, glGetUniformLocation(program, (str + "diffuse").c_str()), 1, plInfo->base.diffuse.data());
-		glProgramUniform3fv(program, glGetUniformLocation(program, (str + "specular").c_str()), 1, plInfo->base.specular.data());
+	//An empty range cannot be bound, so with no lights one black light is uploaded
+	//It adds nothing to the shading, and the unit constant term keeps its attenuation finite
+	if (count == 0)
+	{
+		Nova::PointLightData black;
+		black.position = black.ambient = black.diffuse = black.specular = Nova::Vector4::Zero();
+		black.attenuation << 1.0f, 0.0f, 0.0f, 0.0f;
 
-		glProgramUniform1f(program, glGetUniformLocation(program, (str + "constant").c_str()), plInfo->constant);
-		glProgramUniform1f(program, glGetUniformLocation(program, (str + "linear").c_str()), plInfo->linear);
-		glProgramUniform1f(program, glGetUniformLocation(program, (str + "quadratic").c_str()), plInfo->quadratic);
+		copyLights(0, &black, 1);
 	}
+
+	//The bound range is exactly the lights, shaders take the count from its length
+	glState.bindBufferRange(GL_SHADER_STORAGE_BUFFER, Nova::CONST::POINT_LIGHT_BINDING, lightBuffer, 0, sizeof(Nova::PointLightData) * std::max(count, 1u));
+	boundCount = count;
+}
+
+void Nova::Lighting::LightManager::copyLights(Nova::UInt first, const Nova::PointLightData* lights, Nova::UInt count)
+{
+	Nova::UInt size = sizeof(Nova::PointLightData) * count;
+
+	Nova::UInt offset;
+	std::memcpy(lightStream.allocate(size, offset), lights, size);
+
+	//The copy is ordered after earlier draws on the GPU, unlike a sub data upload which may stall until they finish
+	glCopyNamedBufferSubData(lightStream.getBuffer(), lightBuffer, offset, sizeof(Nova::PointLightData) * first, size);
 }
 
 Nova::UInt Nova::Lighting::LightManager::getPointLightCount()
@@ -83,37 +228,78 @@ Nova::UInt Nova::Lighting::LightManager::getPointLightCount()
 	return pointLights.size();
 }
 
-void Nova::Lighting::LightManager::loadPointLights()
+const Nova::Array<Nova::Vector4>& Nova::Lighting::LightManager::getLightBounds() const
 {
-	for (auto program : programs)
+	return lightBounds;
+}
+
+const Nova::LightGrid& Nova::Lighting::LightManager::getLightGrid() const
+{
+	return lightGrid;
+}
+
+Nova::UInt Nova::Lighting::LightManager::selectLights(const Nova::Vector4& bounds, Nova::ObjectLights& selected, Nova::Array<Nova::UInt>& candidates) const
+{
+	lightGrid.querySphere(bounds, candidates);
+	Nova::UInt reached = candidates.size();
+
+	//How bright the light is at the closest point of the bounds, ambient counts since it is attenuated too
+	auto influence = [this, &bounds](Nova::UInt slot)
 	{
-		for (int i = 0; i < pointLights.size(); ++i)
-		{
-			auto plInfo = pointLights[i].get<Nova::Component::PointLight>();
-			auto transform = pointLights[i].get<Nova::Component::Transform>();
+		const Nova::PointLightData& light = lightData[slot];
+		Nova::Float intensity = (light.ambient + light.diffuse).head<3>().maxCoeff();
+		Nova::Float dist = std::max((light.position.head<3>() - bounds.head<3>()).norm() - bounds.w(), 0.0f);
 
-			std::string str = "pointLights[";
-			str += std::to_string(i);
-			str += "].";
+		return intensity / (light.attenuation.x() + light.attenuation.y() * dist + light.attenuation.z() * dist * dist);
+	};
 
-			glProgramUniform3fv(program, glGetUniformLocation(program, (str + "pos").c_str()), 1, transform->position.data());
+	//Ties go to the lower slot so the choice does not flicker between frames
+	if (candidates.size() > Nova::CONST::MAX_OBJECT_LIGHTS)
+	{
+		std::partial_sort(candidates.begin(), candidates.begin() + Nova::CONST::MAX_OBJECT_LIGHTS, candidates.end(),
+			[&influence](Nova::UInt a, Nova::UInt b)
+			{
+				Nova::Float influenceA = influence(a);
+				Nova::Float influenceB = influence(b);
 
-			glProgramUniform3fv(program, glGetUniformLocation(program, (str + "ambient").c_str()), 1, plInfo->base.ambient.data());
-			glProgramUniform3fv(program, glGetUniformLocation(program, (str + "diffuse").c_str()), 1, plInfo->base.diffuse.data());
-			glProgramUniform3fv(program, glGetUniformLocation(program, (str + "specular").c_str()), 1, plInfo->base.specular.data());
+				return influenceA > influenceB || (influenceA == influenceB && a < b);
+			});
 
-			glProgramUniform1f(program, glGetUniformLocation(program, (str + "constant").c_str()), plInfo->constant);
-			glProgramUniform1f(program, glGetUniformLocation(program, (str + "linear").c_str()), plInfo->linear);
-			glProgramUniform1f(program, glGetUniformLocation(program, (str + "quadratic").c_str()), plInfo->quadratic);
-		}
+		candidates.resize(Nova::CONST::MAX_OBJECT_LIGHTS);
+	}
+
+	selected.count = candidates.size();
+	std::copy(candidates.begin(), candidates.end(), selected.lights);
 
-		glProgramUniform1i(program, glGetUniformLocation(program, "nPointLights"), pointLights.size());
+	return reached;
+}
+
+void Nova::Lighting::LightManager::setAttenuationCutoff(Nova::Float cutoff)
+{
+	if (cutoff <= 0.0f || cutoff == this->cutoff)
+	{
+		return;
 	}
+
+	this->cutoff = cutoff;
+
+	//Radii depend on the cutoff, so every light and its place in the grid must be rebuilt
+	loadPointLights();
+}
+
+Nova::Float Nova::Lighting::LightManager::getAttenuationCutoff() const
+{
+	return cutoff;
 }
 
 void Nova::Lighting::LightManager::deleteLights()
 {
 	pointLights.clear();
 	pointLights.shrink_to_fit();
-	loadPointLights();
-}
+	lightBounds.clear();
+	lightData.clear();
+	lightGrid.clear();
+	slots.clear();
+	dirtySlots.clear();
+	dirty.clear();
+}
\ No newline at end of file
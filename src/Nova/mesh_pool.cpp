@@ -0,0 +1,176 @@
+#include <Nova/mesh_pool.hpp>
+
+#include <iostream>
+#include <algorithm>
+#include <glad/glad.h>
+
+#include <Nova/engine.hpp>
+
+Nova::MeshPool::MeshPool()
+{
+	VAO = VBO = EBO = 0;
+	vertexCapacity = indexCapacity = 0;
+}
+
+void Nova::MeshPool::init(Nova::UInt vertexCapacity, Nova::UInt indexCapacity)
+{
+	this->vertexCapacity = vertexCapacity;
+	this->indexCapacity = indexCapacity;
+
+	glCreateVertexArrays(1, &VAO);
+	glCreateBuffers(1, &VBO);
+	glCreateBuffers(1, &EBO);
+
+	glNamedBufferData(VBO, sizeof(Nova::VertexData) * vertexCapacity, NULL, GL_STATIC_DRAW);
+	glNamedBufferData(EBO, sizeof(Nova::UInt) * indexCapacity, NULL, GL_STATIC_DRAW);
+
+	glVertexArrayVertexBuffer(VAO, 0, VBO, 0, sizeof(Nova::VertexData));
+	glVertexArrayElementBuffer(VAO, EBO);
+
+	//Position attributes
+	glEnableVertexArrayAttrib(VAO, 0);
+	glVertexArrayAttribFormat(VAO, 0, 3, GL_FLOAT, GL_FALSE, offsetof(Nova::VertexData, pos));
+	glVertexArrayAttribBinding(VAO, 0, 0);
+
+	//Normal attributes
+	glEnableVertexArrayAttrib(VAO, 1);
+	glVertexArrayAttribFormat(VAO, 1, 3, GL_FLOAT, GL_FALSE, offsetof(Nova::VertexData, normal));
+	glVertexArrayAttribBinding(VAO, 1, 0);
+
+	//UV attributes
+	glEnableVertexArrayAttrib(VAO, 2);
+	glVertexArrayAttribFormat(VAO, 2, 2, GL_FLOAT, GL_FALSE, offsetof(Nova::VertexData, uv));
+	glVertexArrayAttribBinding(VAO, 2, 0);
+
+	freeVertices = { { 0, vertexCapacity } };
+	freeIndices = { { 0, indexCapacity } };
+}
+
+void Nova::MeshPool::destroy()
+{
+	glDeleteVertexArrays(1, &VAO);
+	glDeleteBuffers(1, &VBO);
+	glDeleteBuffers(1, &EBO);
+
+	VAO = VBO = EBO = 0;
+	freeVertices.clear();
+	freeIndices.clear();
+}
+
+bool Nova::MeshPool::allocate(const Nova::VertexData* vertices, Nova::UInt vertexCount, const Nova::UInt* indices, Nova::UInt indexCount, Nova::MeshInfo& meshInfo)
+{
+	Nova::UInt vertexOffset, indexOffset;
+
+	if (!allocateRange(freeVertices, vertexCount, vertexOffset))
+	{
+		vertexCapacity = grow(VBO, vertexCapacity, vertexCount, sizeof(Nova::VertexData), freeVertices);
+		glVertexArrayVertexBuffer(VAO, 0, VBO, 0, sizeof(Nova::VertexData));
+		allocateRange(freeVertices, vertexCount, vertexOffset);
+	}
+
+	if (!allocateRange(freeIndices, indexCount, indexOffset))
+	{
+		indexCapacity = grow(EBO, indexCapacity, indexCount, sizeof(Nova::UInt), freeIndices);
+		glVertexArrayElementBuffer(VAO, EBO);
+		allocateRange(freeIndices, indexCount, indexOffset);
+	}
+
+	glNamedBufferSubData(VBO, sizeof(Nova::VertexData) * vertexOffset, sizeof(Nova::VertexData) * vertexCount, vertices);
+	glNamedBufferSubData(EBO, sizeof(Nova::UInt) * indexOffset, sizeof(Nova::UInt) * indexCount, indices);
+
+	//Indices stay local to the mesh, baseVertex moves them to the mesh's range
+	meshInfo.VAO = VAO;
+	meshInfo.baseVertex = vertexOffset;
+	meshInfo.vertexCount = vertexCount;
+	meshInfo.firstIndex = indexOffset;
+	meshInfo.indexCount = indexCount;
+
+	return true;
+}
+
+void Nova::MeshPool::free(const Nova::MeshInfo& meshInfo)
+{
+	if (meshInfo.VAO != VAO)
+	{
+		std::cerr << "WARNING: Mesh " << meshInfo.name << " does not belong to the mesh pool." << std::endl;
+		return;
+	}
+
+	releaseRange(freeVertices, meshInfo.baseVertex, meshInfo.vertexCount);
+	releaseRange(freeIndices, meshInfo.firstIndex, meshInfo.indexCount);
+}
+
+Nova::UInt Nova::MeshPool::getVAO() const
+{
+	return VAO;
+}
+
+//First fit, meshes are loaded rarely so fragmentation matters more than speed
+bool Nova::MeshPool::allocateRange(Nova::Array<Range>& freeList, Nova::UInt count, Nova::UInt& offset)
+{
+	for (size_t i = 0; i < freeList.size(); ++i)
+	{
+		Range& range = freeList[i];
+
+		if (range.count >= count)
+		{
+			offset = range.offset;
+			range.offset += count;
+			range.count -= count;
+
+			if (range.count == 0)
+			{
+				freeList.erase(freeList.begin() + i);
+			}
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void Nova::MeshPool::releaseRange(Nova::Array<Range>& freeList, Nova::UInt offset, Nova::UInt count)
+{
+	auto it = std::lower_bound(freeList.begin(), freeList.end(), offset,
+		[](const Range& range, Nova::UInt offset) { return range.offset < offset; });
+	it = freeList.insert(it, { offset, count });
+
+	//Merge with the following range
+	auto next = it + 1;
+	if (next != freeList.end() && it->offset + it->count == next->offset)
+	{
+		it->count += next->count;
+		freeList.erase(next);
+	}
+
+	//Merge with the preceding range
+	if (it != freeList.begin())
+	{
+		auto prev = it - 1;
+		if (prev->offset + prev->count == it->offset)
+		{
+			prev->count += it->count;
+			freeList.erase(it);
+		}
+	}
+}
+
+Nova::UInt Nova::MeshPool::grow(Nova::UInt& buffer, Nova::UInt capacity, Nova::UInt required, Nova::UInt elementSize, Nova::Array<Range>& freeList)
+{
+	Nova::UInt newCapacity = std::max(capacity * 2, capacity + required);
+
+	Nova::UInt newBuffer;
+	glCreateBuffers(1, &newBuffer);
+	glNamedBufferData(newBuffer, static_cast<GLsizeiptr>(elementSize) * newCapacity, NULL, GL_STATIC_DRAW);
+	glCopyNamedBufferSubData(buffer, newBuffer, 0, 0, static_cast<GLsizeiptr>(elementSize) * capacity);
+	glDeleteBuffers(1, &buffer);
+	buffer = newBuffer;
+
+	releaseRange(freeList, capacity, newCapacity - capacity);
+
+	//The old buffer may have been bound somewhere
+	Nova::glState.invalidate();
+
+	return newCapacity;
+}
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include <glad/glad.h>
 
 #include <vector>
+#include <cmath>
+#include <algorithm>
 #include <Nova/types.hpp>
 #include <Nova/components.hpp>
 #include <Nova/utils.hpp>
@@ -76,48 +78,86 @@ Nova::UInt cubeIndices[] =
 Nova::MeshInfo Nova::loadCubeMesh()
 {
     Nova::MeshInfo meshInfo;
-
-    //Load mesh for cube
-    Nova::UInt VAO, VBO, EBO;
-    Nova::Component::Mesh mesh;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
-
-    //Set mesh properties for use in GL commands
-    meshInfo.VAO = VAO;
-    meshInfo.VBO = VBO;
-    meshInfo.EBO = EBO;
-    meshInfo.indexCount = 36; //Size of constant array
     meshInfo.name = "Cube Mesh";
+    Nova::computeMeshBounds(meshInfo, cubeVertices, NUM_CUBE_VERTICES);
+
+    //Copy the cube into the shared mesh pool, this sets the VAO and offsets
+    meshPool.allocate(cubeVertices, NUM_CUBE_VERTICES, cubeIndices, 36, meshInfo); //Size of constant array
     globalMeshes.push_back(meshInfo);
 
-    //Bind relevant objects
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    return meshInfo;
+}
 
-    //Set data in buffer
-    glBufferData(GL_ARRAY_BUFFER, sizeof(Nova::VertexData) * 36, cubeVertices, GL_STATIC_DRAW);
+void Nova::generateSphere(Nova::UInt rings, Nova::UInt segments, Nova::Array<Nova::VertexData>& vertices, Nova::Array<Nova::UInt>& indices)
+{
+    vertices.clear();
+    indices.clear();
+    vertices.reserve((rings + 1) * (segments + 1));
+    indices.reserve(rings * segments * 6);
 
-    //Position attributes
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Nova::VertexData), (void*)offsetof(Nova::VertexData, pos));
-    glEnableVertexAttribArray(0);
+    //Seams and poles get duplicate vertices so UVs wrap cleanly
+    for (Nova::UInt r = 0; r <= rings; ++r)
+    {
+        Nova::Float v = static_cast<Nova::Float>(r) / rings;
+        Nova::Float phi = v * 3.1415927f;
 
-    //Normal attributes
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Nova::VertexData), (void*)offsetof(Nova::VertexData, normal));
-    glEnableVertexAttribArray(1);
+        for (Nova::UInt s = 0; s <= segments; ++s)
+        {
+            Nova::Float u = static_cast<Nova::Float>(s) / segments;
+            Nova::Float theta = u * 2.0f * 3.1415927f;
 
-    //UV attributes
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Nova::VertexData), (void*)offsetof(Nova::VertexData, uv));
-    glEnableVertexAttribArray(2);
+            Nova::Vector3 normal(sinf(phi) * cosf(theta), cosf(phi), sinf(phi) * sinf(theta));
+            vertices.push_back({ normal * 0.5f, normal, { u, 1.0f - v } });
+        }
+    }
 
-    //Set indices
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(Nova::UInt) * 36, cubeIndices, GL_STATIC_DRAW);
+    for (Nova::UInt r = 0; r < rings; ++r)
+    {
+        for (Nova::UInt s = 0; s < segments; ++s)
+        {
+            Nova::UInt a = r * (segments + 1) + s;
+            Nova::UInt b = a + segments + 1;
+
+            indices.insert(indices.end(), { a, a + 1, b, b, a + 1, b + 1 });
+        }
+    }
+}
+
+Nova::MeshInfo Nova::loadSphereMesh(Nova::UInt rings, Nova::UInt segments)
+{
+    Nova::Array<Nova::VertexData> vertices;
+    Nova::Array<Nova::UInt> indices;
+    generateSphere(rings, segments, vertices, indices);
+
+    Nova::MeshInfo meshInfo;
+    meshInfo.name = "Sphere Mesh";
+    Nova::computeMeshBounds(meshInfo, vertices.data(), vertices.size());
+
+    meshPool.allocate(vertices.data(), vertices.size(), indices.data(), indices.size(), meshInfo);
+    globalMeshes.push_back(meshInfo);
 
     return meshInfo;
 }
 
+bool Nova::generateMesh(const Nova::String& name, Nova::Array<Nova::VertexData>& vertices, Nova::Array<Nova::UInt>& indices)
+{
+    if (name == "Cube Mesh")
+    {
+        vertices.assign(cubeVertices, cubeVertices + NUM_CUBE_VERTICES);
+        indices.assign(cubeIndices, cubeIndices + 36);
+        return true;
+    }
+
+    //Same tessellation createSphere loads into the pool
+    if (name == "Sphere Mesh")
+    {
+        generateSphere(Nova::CONST::DENSE_SPHERE_RINGS, Nova::CONST::DENSE_SPHERE_SEGMENTS, vertices, indices);
+        return true;
+    }
+
+    return false;
+}
+
 Nova::Entity Nova::createCube()
 {
     //TODO: Remove this code eventually
@@ -153,6 +193,28 @@ Nova::Entity Nova::createCube()
     return cube;
 }
 
+Nova::Entity Nova::createSphere()
+{
+    //The sphere is dense enough to be vertex bound, so it is only loaded once something uses it
+    bool loaded = std::any_of(Nova::globalMeshes.begin(), Nova::globalMeshes.end(),
+        [](const Nova::MeshInfo& mesh) { return mesh.name == "Sphere Mesh"; });
+
+    if (!loaded)
+    {
+        loadSphereMesh(Nova::CONST::DENSE_SPHERE_RINGS, Nova::CONST::DENSE_SPHERE_SEGMENTS);
+    }
+
+    Nova::Entity sphere = Nova::ecs.entity();
+    sphere.set<Nova::Component::Transform>(Nova::Component::DEFAULT_TRANSFORM);
+
+    Nova::Component::Mesh mesh;
+    mesh.meshInfo = findMesh("Sphere Mesh", Nova::globalMeshes);
+
+    sphere.set<Nova::Component::Mesh>(mesh);
+
+    return sphere;
+}
+
 flecs::entity Nova::createCamera()
 {
     flecs::entity cam = Nova::ecs.entity();
@@ -200,4 +262,15 @@ flecs::entity Nova::createDefaultPointLight()
     plProps.quadratic = 0.032f;
 
     return Nova::createLightCube(plProps);
+}
+
+flecs::entity Nova::createDirectionalLight()
+{
+    flecs::entity light = Nova::ecs.entity();
+    light.add<Nova::Component::Transform>();
+    light.set<Nova::Component::Transform>(Nova::Component::DEFAULT_TRANSFORM);
+    light.add<Nova::Component::DirectionalLight>();
+    light.set<Nova::Component::DirectionalLight>(Nova::Component::DEFAULT_DIRECTIONAL_LIGHT);
+
+    return light;
 }
\ No newline at end of file
@@ -0,0 +1,305 @@
+#include <Nova/probe_baker.hpp>
+
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+//Hits this close to either end of a shadow ray are ignored, so surfaces touching a probe or light do not block it
+static constexpr Nova::Float RAY_EPSILON = 1e-4f;
+
+//Deep enough for any BVH, median splits halve the triangles at every level
+static constexpr Nova::UInt BVH_STACK_SIZE = 64;
+
+//Probe faces in the order ProbeData stores them
+static const Nova::Vector3 PROBE_AXES[6] =
+{
+	{  1.0f,  0.0f,  0.0f },
+	{ -1.0f,  0.0f,  0.0f },
+	{  0.0f,  1.0f,  0.0f },
+	{  0.0f, -1.0f,  0.0f },
+	{  0.0f,  0.0f,  1.0f },
+	{  0.0f,  0.0f, -1.0f }
+};
+
+Nova::ProbeBaker::ProbeBaker()
+{
+}
+
+void Nova::ProbeBaker::addMesh(const Nova::Array<Nova::VertexData>& vertices, const Nova::Array<Nova::UInt>& indices, const Nova::Matrix4& model)
+{
+	Nova::Array<Nova::Vector3> world(vertices.size());
+	for (Nova::UInt i = 0; i < vertices.size(); ++i)
+	{
+		world[i] = (model * vertices[i].pos.homogeneous()).head<3>();
+	}
+
+	for (Nova::UInt i = 0; i + 2 < indices.size(); i += 3)
+	{
+		Triangle triangle;
+		triangle.v0 = world[indices[i]];
+		triangle.edge1 = world[indices[i + 1]] - triangle.v0;
+		triangle.edge2 = world[indices[i + 2]] - triangle.v0;
+
+		//Degenerate triangles can never be hit
+		if (triangle.edge1.cross(triangle.edge2).squaredNorm() > 0.0f)
+		{
+			triangles.push_back(triangle);
+		}
+	}
+
+	nodes.clear();
+}
+
+void Nova::ProbeBaker::addLight(const Nova::PointLightData& light)
+{
+	lightGrid.update(lights.size(), light.position);
+	lights.push_back(light);
+}
+
+void Nova::ProbeBaker::clear()
+{
+	triangles.clear();
+	nodes.clear();
+	lights.clear();
+	lightGrid.clear();
+}
+
+bool Nova::ProbeBaker::bake(Nova::ProbeGrid& grid, Nova::JobSystem& jobs, Nova::Float spacing)
+{
+	if (triangles.empty())
+	{
+		std::cerr << "WARNING: No static meshes to bake probes around." << std::endl;
+		grid.clear();
+		return false;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	buildBVH();
+
+	//The root node bounds every static mesh
+	Nova::Vector3 margin = Nova::Vector3::Constant(Nova::CONST::PROBE_MARGIN);
+	grid.resize(nodes[0].min - margin, nodes[0].max + margin, spacing);
+
+	//Each chunk keeps its own candidate list, probes only write their own slot
+	Nova::Array<Nova::ProbeData>& probes = grid.getProbes();
+	jobs.parallelFor(grid.getProbeCount(), Nova::CONST::PROBES_PER_JOB, [&](Nova::UInt begin, Nova::UInt end)
+	{
+		Nova::Array<Nova::UInt> candidates;
+		for (Nova::UInt i = begin; i < end; ++i)
+		{
+			probes[i] = bakeProbe(grid.getProbePosition(i), candidates);
+		}
+	});
+
+	Nova::Float ms = std::chrono::duration<Nova::Float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	std::cout << "Baked " << grid.getProbeCount() << " probes from " << triangles.size() << " triangles and " << lights.size()
+		<< " lights on " << jobs.getThreadCount() << " threads in " << ms << " ms" << std::endl;
+
+	return true;
+}
+
+Nova::UInt Nova::ProbeBaker::getTriangleCount() const
+{
+	return triangles.size();
+}
+
+Nova::UInt Nova::ProbeBaker::getLightCount() const
+{
+	return lights.size();
+}
+
+void Nova::ProbeBaker::buildBVH()
+{
+	Nova::Array<Nova::UInt> order(triangles.size());
+	Nova::Array<Nova::Vector3> centroids(triangles.size());
+
+	for (Nova::UInt i = 0; i < triangles.size(); ++i)
+	{
+		const Triangle& triangle = triangles[i];
+
+		order[i] = i;
+		centroids[i] = triangle.v0 + (triangle.edge1 + triangle.edge2) / 3.0f;
+	}
+
+	nodes.clear();
+	nodes.reserve(2 * triangles.size() / Nova::CONST::PROBE_BVH_LEAF_SIZE + 1);
+	nodes.emplace_back();
+	buildNode(0, 0, triangles.size(), order, centroids);
+
+	//Store the triangles in leaf order so each leaf is one contiguous run
+	Nova::Array<Triangle> sorted(triangles.size());
+	for (Nova::UInt i = 0; i < order.size(); ++i)
+	{
+		sorted[i] = triangles[order[i]];
+	}
+
+	triangles.swap(sorted);
+}
+
+void Nova::ProbeBaker::buildNode(Nova::UInt node, Nova::UInt first, Nova::UInt count, Nova::Array<Nova::UInt>& order, const Nova::Array<Nova::Vector3>& centroids)
+{
+	Nova::Vector3 min = Nova::Vector3::Constant(std::numeric_limits<Nova::Float>::max());
+	Nova::Vector3 max = -min;
+	Nova::Vector3 centroidMin = min;
+	Nova::Vector3 centroidMax = max;
+
+	for (Nova::UInt i = first; i < first + count; ++i)
+	{
+		const Triangle& triangle = triangles[order[i]];
+		Nova::Vector3 v1 = triangle.v0 + triangle.edge1;
+		Nova::Vector3 v2 = triangle.v0 + triangle.edge2;
+
+		min = min.cwiseMin(triangle.v0).cwiseMin(v1).cwiseMin(v2);
+		max = max.cwiseMax(triangle.v0).cwiseMax(v1).cwiseMax(v2);
+		centroidMin = centroidMin.cwiseMin(centroids[order[i]]);
+		centroidMax = centroidMax.cwiseMax(centroids[order[i]]);
+	}
+
+	nodes[node].min = min;
+	nodes[node].max = max;
+
+	//Triangles sharing one centroid cannot be split, so they stay in a leaf
+	Nova::Int axis;
+	Nova::Float width = (centroidMax - centroidMin).maxCoeff(&axis);
+	if (count <= Nova::CONST::PROBE_BVH_LEAF_SIZE || width <= 0.0f)
+	{
+		nodes[node].first = first;
+		nodes[node].count = count;
+		return;
+	}
+
+	Nova::UInt half = count / 2;
+	std::nth_element(order.begin() + first, order.begin() + first + half, order.begin() + first + count,
+		[&centroids, axis](Nova::UInt a, Nova::UInt b) { return centroids[a][axis] < centroids[b][axis]; });
+
+	//The left child is pushed first so it always follows its parent
+	Nova::UInt left = nodes.size();
+	nodes.emplace_back();
+	buildNode(left, first, half, order, centroids);
+
+	Nova::UInt right = nodes.size();
+	nodes.emplace_back();
+	buildNode(right, first + half, count - half, order, centroids);
+
+	nodes[node].first = right;
+	nodes[node].count = 0;
+}
+
+bool Nova::ProbeBaker::occluded(const Nova::Vector3& from, const Nova::Vector3& to) const
+{
+	Nova::Vector3 dir = to - from;
+	Nova::Vector3 invDir = dir.cwiseInverse();
+
+	Nova::UInt stack[BVH_STACK_SIZE];
+	Nova::UInt size = 0;
+	stack[size++] = 0;
+
+	while (size > 0)
+	{
+		Nova::UInt index = stack[--size];
+		const Node& node = nodes[index];
+
+		//Slab test against the segment, t runs from 0 at from to 1 at to
+		Nova::Vector3 t1 = (node.min - from).cwiseProduct(invDir);
+		Nova::Vector3 t2 = (node.max - from).cwiseProduct(invDir);
+		Nova::Float tNear = std::max(t1.cwiseMin(t2).maxCoeff(), 0.0f);
+		Nova::Float tFar = std::min(t1.cwiseMax(t2).minCoeff(), 1.0f);
+
+		if (tNear > tFar)
+		{
+			continue;
+		}
+
+		if (node.count == 0)
+		{
+			stack[size++] = node.first;
+			stack[size++] = index + 1;
+			continue;
+		}
+
+		//Any hit is enough for a shadow ray, so the first one found ends the search
+		for (Nova::UInt i = node.first; i < node.first + node.count; ++i)
+		{
+			const Triangle& triangle = triangles[i];
+
+			Nova::Vector3 p = dir.cross(triangle.edge2);
+			Nova::Float det = triangle.edge1.dot(p);
+			if (std::abs(det) < std::numeric_limits<Nova::Float>::epsilon())
+			{
+				continue;
+			}
+
+			Nova::Float invDet = 1.0f / det;
+			Nova::Vector3 s = from - triangle.v0;
+			Nova::Float u = s.dot(p) * invDet;
+			if (u < 0.0f || u > 1.0f)
+			{
+				continue;
+			}
+
+			Nova::Vector3 q = s.cross(triangle.edge1);
+			Nova::Float v = dir.dot(q) * invDet;
+			if (v < 0.0f || u + v > 1.0f)
+			{
+				continue;
+			}
+
+			Nova::Float t = triangle.edge2.dot(q) * invDet;
+			if (t > RAY_EPSILON && t < 1.0f - RAY_EPSILON)
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+Nova::ProbeData Nova::ProbeBaker::bakeProbe(const Nova::Vector3& position, Nova::Array<Nova::UInt>& candidates) const
+{
+	Nova::ProbeData probe;
+	for (auto& face : probe.cube)
+	{
+		face.setZero();
+	}
+
+	candidates.clear();
+	lightGrid.querySphere(Nova::Vector4(position.x(), position.y(), position.z(), 0.0f), candidates);
+
+	for (Nova::UInt l : candidates)
+	{
+		const Nova::PointLightData& light = lights[l];
+
+		//Same falloff as the forward shader, nothing past the light's radius
+		Nova::Vector3 toLight = light.position.head<3>() - position;
+		Nova::Float dist = toLight.norm();
+		if (dist > light.position.w())
+		{
+			continue;
+		}
+
+		Nova::Float attenuation = 1.0f / (light.attenuation.x() + light.attenuation.y() * dist + light.attenuation.z() * dist * dist);
+
+		//Ambient light reaches every face and is never shadowed
+		for (auto& face : probe.cube)
+		{
+			face += light.ambient * attenuation;
+		}
+
+		if (dist <= 0.0f || occluded(position, light.position.head<3>()))
+		{
+			continue;
+		}
+
+		Nova::Vector3 lightDir = toLight / dist;
+		for (Nova::UInt f = 0; f < 6; ++f)
+		{
+			probe.cube[f] += light.diffuse * attenuation * std::max(PROBE_AXES[f].dot(lightDir), 0.0f);
+		}
+	}
+
+	return probe;
+}
\ No newline at end of file
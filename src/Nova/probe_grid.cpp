@@ -0,0 +1,174 @@
+#include <Nova/probe_grid.hpp>
+
+#include <iostream>
+#include <fstream>
+#include <cmath>
+#include <algorithm>
+#include <glad/glad.h>
+
+#include <Nova/engine.hpp>
+
+//Identifies probe files, the version changes whenever the layout does
+static constexpr Nova::UInt PROBE_FILE_MAGIC = 0x4250564E; //"NVPB"
+static constexpr Nova::UInt PROBE_FILE_VERSION = 1;
+
+Nova::ProbeGrid::ProbeGrid()
+{
+	origin = Nova::Vector3::Zero();
+	spacing = Nova::CONST::PROBE_SPACING;
+	dims = Nova::Vector3i::Zero();
+	buffer = 0;
+}
+
+void Nova::ProbeGrid::init()
+{
+	glCreateBuffers(1, &buffer);
+	upload();
+}
+
+void Nova::ProbeGrid::destroy()
+{
+	glDeleteBuffers(1, &buffer);
+	buffer = 0;
+}
+
+void Nova::ProbeGrid::resize(const Nova::Vector3& min, const Nova::Vector3& max, Nova::Float probeSpacing)
+{
+	Nova::Vector3 extent = (max - min).cwiseMax(0.0f);
+
+	//Widen the spacing until the longest axis fits, probes sit on both ends of every axis
+	Nova::Float longest = extent.maxCoeff();
+	spacing = std::max(probeSpacing, longest / (Nova::CONST::PROBE_GRID_MAX_DIM - 1));
+
+	for (Nova::Int axis = 0; axis < 3; ++axis)
+	{
+		dims[axis] = static_cast<Nova::Int>(std::ceil(extent[axis] / spacing)) + 1;
+		dims[axis] = std::min(dims[axis], Nova::CONST::PROBE_GRID_MAX_DIM);
+	}
+
+	//Center the grid on the box, the last probe may land a little past max
+	origin = (min + max) * 0.5f - (dims - Nova::Vector3i::Ones()).cast<Nova::Float>() * spacing * 0.5f;
+
+	ProbeData black;
+	for (auto& face : black.cube)
+	{
+		face.setZero();
+	}
+
+	probes.assign(static_cast<std::size_t>(dims.prod()), black);
+}
+
+void Nova::ProbeGrid::clear()
+{
+	dims.setZero();
+	probes.clear();
+	probes.shrink_to_fit();
+}
+
+void Nova::ProbeGrid::upload()
+{
+	Header header;
+	header.origin << origin, spacing;
+	header.dims[0] = dims.x();
+	header.dims[1] = dims.y();
+	header.dims[2] = dims.z();
+	header.dims[3] = 0;
+
+	//Probes follow the header directly, it is already a multiple of their alignment
+	Nova::UInt probeSize = sizeof(Nova::ProbeData) * probes.size();
+	glNamedBufferData(buffer, sizeof(Header) + probeSize, nullptr, GL_STATIC_DRAW);
+	glNamedBufferSubData(buffer, 0, sizeof(Header), &header);
+
+	if (!probes.empty())
+	{
+		glNamedBufferSubData(buffer, sizeof(Header), probeSize, probes.data());
+	}
+
+	glState.bindBufferBase(GL_SHADER_STORAGE_BUFFER, Nova::CONST::PROBE_GRID_BINDING, buffer);
+}
+
+bool Nova::ProbeGrid::save(const Nova::String& filepath) const
+{
+	std::ofstream file(filepath, std::ios::binary);
+	if (!file)
+	{
+		std::cerr << "ERROR: Could not write probe file: " << filepath << std::endl;
+		return false;
+	}
+
+	file.write(reinterpret_cast<const char*>(&PROBE_FILE_MAGIC), sizeof(Nova::UInt));
+	file.write(reinterpret_cast<const char*>(&PROBE_FILE_VERSION), sizeof(Nova::UInt));
+	file.write(reinterpret_cast<const char*>(dims.data()), sizeof(Nova::Int) * 3);
+	file.write(reinterpret_cast<const char*>(origin.data()), sizeof(Nova::Float) * 3);
+	file.write(reinterpret_cast<const char*>(&spacing), sizeof(Nova::Float));
+	file.write(reinterpret_cast<const char*>(probes.data()), sizeof(Nova::ProbeData) * probes.size());
+
+	return static_cast<bool>(file);
+}
+
+bool Nova::ProbeGrid::load(const Nova::String& filepath)
+{
+	std::ifstream file(filepath, std::ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+
+	Nova::UInt magic = 0, version = 0;
+	Nova::Vector3i fileDims;
+	Nova::Vector3 fileOrigin;
+	Nova::Float fileSpacing;
+
+	file.read(reinterpret_cast<char*>(&magic), sizeof(Nova::UInt));
+	file.read(reinterpret_cast<char*>(&version), sizeof(Nova::UInt));
+	file.read(reinterpret_cast<char*>(fileDims.data()), sizeof(Nova::Int) * 3);
+	file.read(reinterpret_cast<char*>(fileOrigin.data()), sizeof(Nova::Float) * 3);
+	file.read(reinterpret_cast<char*>(&fileSpacing), sizeof(Nova::Float));
+
+	if (!file || magic != PROBE_FILE_MAGIC || version != PROBE_FILE_VERSION
+		|| fileDims.minCoeff() < 0 || fileDims.maxCoeff() > Nova::CONST::PROBE_GRID_MAX_DIM)
+	{
+		std::cerr << "WARNING: Not a valid probe file: " << filepath << std::endl;
+		return false;
+	}
+
+	Nova::Array<Nova::ProbeData> fileProbes(static_cast<std::size_t>(fileDims.prod()));
+	file.read(reinterpret_cast<char*>(fileProbes.data()), sizeof(Nova::ProbeData) * fileProbes.size());
+
+	if (!file)
+	{
+		std::cerr << "WARNING: Probe file is truncated: " << filepath << std::endl;
+		return false;
+	}
+
+	dims = fileDims;
+	origin = fileOrigin;
+	spacing = fileSpacing;
+	probes = std::move(fileProbes);
+
+	return true;
+}
+
+Nova::Vector3 Nova::ProbeGrid::getProbePosition(Nova::UInt index) const
+{
+	Nova::Int x = index % dims.x();
+	Nova::Int y = (index / dims.x()) % dims.y();
+	Nova::Int z = index / (dims.x() * dims.y());
+
+	return origin + Nova::Vector3(x, y, z) * spacing;
+}
+
+Nova::UInt Nova::ProbeGrid::getProbeCount() const
+{
+	return probes.size();
+}
+
+Nova::Array<Nova::ProbeData>& Nova::ProbeGrid::getProbes()
+{
+	return probes;
+}
+
+bool Nova::ProbeGrid::empty() const
+{
+	return probes.empty();
+}
\ No newline at end of file
@@ -0,0 +1,236 @@
+#include <Nova/program_cache.hpp>
+
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cstdio>
+#include <glad/glad.h>
+
+#include <Nova/utils.hpp>
+
+//Identifies cache files, the version changes whenever the layout does
+static constexpr Nova::UInt CACHE_FILE_MAGIC = 0x4843504E; //"NPCH"
+static constexpr Nova::UInt CACHE_FILE_VERSION = 1;
+
+//Real program binaries are far smaller, anything larger is a corrupt file
+static constexpr Nova::UInt MAX_BINARY_SIZE = 64 * 1024 * 1024;
+
+//Layout of the start of a cache file, the binary follows it
+struct CacheHeader
+{
+	Nova::UInt magic;
+	Nova::UInt version;
+	Nova::UInt format;
+	Nova::UInt size;
+};
+
+Nova::ProgramCache::ProgramCache()
+{
+	enabled = false;
+	hits = 0;
+	misses = 0;
+	loadTime = 0.0f;
+	compileTime = 0.0f;
+}
+
+void Nova::ProgramCache::init(const Nova::String& directory)
+{
+	this->directory = directory;
+
+	Nova::Int formats = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+
+	if (formats == 0)
+	{
+		std::cerr << "WARNING: The driver has no program binary formats, shaders will always compile from source." << std::endl;
+		return;
+	}
+
+	std::error_code err;
+	std::filesystem::create_directories(directory, err);
+	if (err)
+	{
+		std::cerr << "WARNING: Could not create the program cache directory: " << directory << std::endl;
+		return;
+	}
+
+	//A driver update can change what a binary means, so the driver is part of every key
+	driver = Nova::String(reinterpret_cast<const char*>(glGetString(GL_VENDOR))) + "\n"
+		+ reinterpret_cast<const char*>(glGetString(GL_RENDERER)) + "\n"
+		+ reinterpret_cast<const char*>(glGetString(GL_VERSION));
+
+	enabled = true;
+}
+
+Nova::UInt64 Nova::ProgramCache::makeKey(const Nova::Array<Nova::String>& sources) const
+{
+	Nova::UInt64 key = Nova::hashBytes(driver.data(), driver.size());
+
+	//Sizes go in too, so moving text from one stage to the next changes the key
+	for (const auto& source : sources)
+	{
+		Nova::UInt64 size = source.size();
+		key = Nova::hashBytes(&size, sizeof(size), key);
+		key = Nova::hashBytes(source.data(), source.size(), key);
+	}
+
+	return key;
+}
+
+Nova::UInt Nova::ProgramCache::load(Nova::UInt64 key)
+{
+	if (!enabled)
+	{
+		return 0;
+	}
+
+	std::ifstream file(pathOf(key), std::ios::binary);
+	if (!file)
+	{
+		return 0;
+	}
+
+	CacheHeader header;
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+	if (!file || header.magic != CACHE_FILE_MAGIC || header.version != CACHE_FILE_VERSION)
+	{
+		return 0;
+	}
+
+	//The size comes from disk, so it has to match what is left of the file before anything is allocated
+	std::streamoff start = file.tellg();
+	file.seekg(0, std::ios::end);
+	std::streamoff remaining = file.tellg() - start;
+	file.seekg(start);
+
+	if (!file || header.size == 0 || header.size > MAX_BINARY_SIZE || remaining != static_cast<std::streamoff>(header.size))
+	{
+		file.close();
+		std::remove(pathOf(key).c_str());
+		return 0;
+	}
+
+	Nova::Array<Nova::UByte> binary(header.size);
+	file.read(reinterpret_cast<char*>(binary.data()), binary.size());
+
+	if (!file)
+	{
+		return 0;
+	}
+
+	file.close();
+
+	Nova::UInt program = glCreateProgram();
+	glProgramBinary(program, header.format, binary.data(), binary.size());
+
+	//A new driver may refuse an old format, the stale file is dropped and rewritten after compiling
+	Nova::Int linked = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &linked);
+
+	if (linked != GL_TRUE)
+	{
+		glDeleteProgram(program);
+		std::remove(pathOf(key).c_str());
+		return 0;
+	}
+
+	return program;
+}
+
+void Nova::ProgramCache::save(Nova::UInt64 key, Nova::UInt program)
+{
+	if (!enabled)
+	{
+		return;
+	}
+
+	Nova::Int length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+
+	if (length <= 0)
+	{
+		return;
+	}
+
+	CacheHeader header = { CACHE_FILE_MAGIC, CACHE_FILE_VERSION, 0, 0 };
+	Nova::Array<Nova::UByte> binary(length);
+
+	GLsizei written = 0;
+	GLenum format = 0;
+	glGetProgramBinary(program, length, &written, &format, binary.data());
+
+	header.format = format;
+	header.size = written;
+
+	//Written under a temporary name and renamed into place, so a crash never leaves a partial entry
+	Nova::String path = pathOf(key);
+	Nova::String temp = path + ".tmp";
+
+	std::ofstream file(temp, std::ios::binary);
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(binary.data()), written);
+	file.close();
+
+	if (!file)
+	{
+		std::cerr << "WARNING: Could not write program cache file: " << path << std::endl;
+		std::remove(temp.c_str());
+		return;
+	}
+
+	std::error_code err;
+	std::filesystem::rename(temp, path, err);
+	if (err)
+	{
+		std::cerr << "WARNING: Could not write program cache file: " << path << std::endl;
+		std::remove(temp.c_str());
+	}
+}
+
+void Nova::ProgramCache::record(bool cached, Nova::Float milliseconds)
+{
+	if (cached)
+	{
+		++hits;
+		loadTime += milliseconds;
+	}
+	else
+	{
+		++misses;
+		compileTime += milliseconds;
+	}
+}
+
+bool Nova::ProgramCache::isEnabled() const
+{
+	return enabled;
+}
+
+Nova::UInt Nova::ProgramCache::getHits() const
+{
+	return hits;
+}
+
+Nova::UInt Nova::ProgramCache::getMisses() const
+{
+	return misses;
+}
+
+Nova::Float Nova::ProgramCache::getLoadTime() const
+{
+	return loadTime;
+}
+
+Nova::Float Nova::ProgramCache::getCompileTime() const
+{
+	return compileTime;
+}
+
+Nova::String Nova::ProgramCache::pathOf(Nova::UInt64 key) const
+{
+	char name[32];
+	std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+
+	return (std::filesystem::path(directory) / name).string();
+}
\ No newline at end of file
@@ -0,0 +1,145 @@
+#include <Nova/render_queue.hpp>
+
+#include <algorithm>
+#include <iostream>
+
+constexpr Nova::UInt PROGRAM_BITS = 8;
+constexpr Nova::UInt DEPTH_BITS = 24;
+constexpr Nova::UInt TEXTURE_BITS = 16;
+constexpr Nova::UInt MESH_BITS = 16;
+constexpr Nova::UInt64 DEPTH_MAX = (1ull << DEPTH_BITS) - 1;
+
+Nova::RenderQueue::RenderQueue()
+{
+	overflowReported = false;
+}
+
+Nova::UInt64 Nova::RenderQueue::makeKey(Nova::UInt program, Nova::UInt mesh, Nova::UInt textures, Nova::Float depth)
+{
+	//Quantize depth so nearer objects get smaller keys (front-to-back)
+	Nova::Float clamped = std::min(std::max(depth, 0.0f), 1.0f);
+	Nova::UInt64 depthBits = static_cast<Nova::UInt64>(clamped * static_cast<Nova::Float>(DEPTH_MAX));
+
+	Nova::UInt64 key = denseId(programIds, program, PROGRAM_BITS);
+	key = (key << TEXTURE_BITS) | denseId(textureIds, textures, TEXTURE_BITS);
+	key = (key << MESH_BITS) | denseId(meshIds, mesh, MESH_BITS);
+	key = (key << DEPTH_BITS) | depthBits;
+
+	return key;
+}
+
+bool Nova::RenderQueue::sameState(Nova::UInt64 a, Nova::UInt64 b)
+{
+	return (a >> DEPTH_BITS) == (b >> DEPTH_BITS);
+}
+
+Nova::UInt Nova::RenderQueue::denseId(std::unordered_map<Nova::UInt, Nova::UInt>& ids, Nova::UInt value, Nova::UInt bits)
+{
+	Nova::UInt limit = 1u << bits;
+
+	auto it = ids.find(value);
+	if (it != ids.end())
+	{
+		return it->second;
+	}
+
+	//Draws are still grouped by their real state, shared ids only interleave them in the sort
+	if (ids.size() >= limit)
+	{
+		if (!overflowReported)
+		{
+			std::cerr << "WARNING: Render queue ran out of key ids, some draws will not be sorted together." << std::endl;
+			overflowReported = true;
+		}
+
+		return limit - 1;
+	}
+
+	Nova::UInt id = static_cast<Nova::UInt>(ids.size());
+	ids.emplace(value, id);
+
+	return id;
+}
+
+void Nova::RenderQueue::clear()
+{
+	items.clear();
+	programIds.clear();
+	textureIds.clear();
+	meshIds.clear();
+}
+
+void Nova::RenderQueue::push(Nova::UInt64 key, Nova::UInt index)
+{
+	items.push_back({ key, index });
+}
+
+Nova::UInt Nova::RenderQueue::sort()
+{
+	Nova::UInt unsortedChanges = countStateChanges();
+
+	//Count all eight byte histograms in a single pass over the keys
+	Nova::UInt histograms[8][256] = {};
+	for (const auto& item : items)
+	{
+		for (Nova::UInt b = 0; b < 8; ++b)
+		{
+			++histograms[b][(item.key >> (b * 8)) & 0xFF];
+		}
+	}
+
+	//Least significant byte first, each pass is a stable counting sort
+	scratch.resize(items.size());
+	for (Nova::UInt b = 0; b < 8; ++b)
+	{
+		Nova::UInt* counts = histograms[b];
+
+		//Every key shares this byte, the pass would not move anything
+		if (counts[(items.empty() ? 0 : (items[0].key >> (b * 8)) & 0xFF)] == items.size())
+		{
+			continue;
+		}
+
+		Nova::UInt offset = 0;
+		for (Nova::UInt i = 0; i < 256; ++i)
+		{
+			Nova::UInt count = counts[i];
+			counts[i] = offset;
+			offset += count;
+		}
+
+		for (const auto& item : items)
+		{
+			scratch[counts[(item.key >> (b * 8)) & 0xFF]++] = item;
+		}
+
+		items.swap(scratch);
+	}
+
+	return unsortedChanges - countStateChanges();
+}
+
+const Nova::Array<Nova::RenderItem>& Nova::RenderQueue::getItems() const
+{
+	return items;
+}
+
+Nova::UInt Nova::RenderQueue::size() const
+{
+	return items.size();
+}
+
+Nova::UInt Nova::RenderQueue::countStateChanges() const
+{
+	Nova::UInt changes = items.empty() ? 0 : 1;
+
+	for (size_t i = 1; i < items.size(); ++i)
+	{
+		if (!sameState(items[i - 1].key, items[i].key))
+		{
+			++changes;
+		}
+	}
+
+	return changes;
+}
\ No newline at end of file
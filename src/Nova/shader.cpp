@@ -1,8 +1,13 @@
 #include <Nova/shader.hpp>
 
 #include <iostream>
+#include <algorithm>
+#include <string>
+#include <chrono>
+#include <cstring>
 
 #include <Nova/utils.hpp>
+#include <Nova/engine.hpp>
 
 void checkCompileErrors(unsigned int shader, std::string type)
 {
@@ -28,6 +33,115 @@ void checkCompileErrors(unsigned int shader, std::string type)
     }
 }
 
+//Feature bits above this hold the object light bucket, plus one so zero means no bucket
+static constexpr Nova::UInt LIGHT_BUCKET_SHIFT = 8;
+
+Nova::UInt Nova::objectLightFeatures(Nova::UInt lightCount)
+{
+    Nova::UInt bucket = 0;
+    while (bucket + 1 < Nova::CONST::OBJECT_LIGHT_BUCKET_COUNT && Nova::CONST::OBJECT_LIGHT_BUCKETS[bucket] < lightCount)
+    {
+        ++bucket;
+    }
+
+    return (bucket + 1) << LIGHT_BUCKET_SHIFT;
+}
+
+Nova::String Nova::shaderDefines(Nova::UInt features)
+{
+    //Engine constants come from const.hpp so the shaders cannot drift from the CPU side
+    Nova::String defines;
+    defines += "#define MAX_SPOT_LIGHTS " + std::to_string(Nova::CONST::MAX_SPOT_LIGHTS) + "\n";
+    defines += "#define MAX_OBJECT_LIGHTS " + std::to_string(Nova::CONST::MAX_OBJECT_LIGHTS) + "\n";
+    defines += "#define SHADOW_CASCADES " + std::to_string(Nova::CONST::SHADOW_CASCADES) + "\n";
+    defines += "#define CLUSTER_X " + std::to_string(Nova::CONST::CLUSTER_X) + "\n";
+    defines += "#define CLUSTER_Y " + std::to_string(Nova::CONST::CLUSTER_Y) + "\n";
+    defines += "#define CLUSTER_Z " + std::to_string(Nova::CONST::CLUSTER_Z) + "\n";
+    defines += "#define OVERDRAW_LAYERS " + std::to_string(Nova::CONST::OVERDRAW_LAYERS) + "\n";
+
+    if (features & Nova::ShaderFeature::UNTEXTURED)
+    {
+        defines += "#define UNTEXTURED\n";
+    }
+
+    if (features & Nova::ShaderFeature::BAKED_LIGHTING)
+    {
+        defines += "#define BAKED_LIGHTING\n";
+    }
+
+    if (features & Nova::ShaderFeature::TEXTURE_ARRAY)
+    {
+        defines += "#define TEXTURE_ARRAY\n";
+    }
+
+    //Exact buckets hold a single light count, so their loop needs no bounds check
+    Nova::UInt bucket = features >> LIGHT_BUCKET_SHIFT;
+    if (bucket > 0)
+    {
+        Nova::UInt count = Nova::CONST::OBJECT_LIGHT_BUCKETS[bucket - 1];
+        defines += "#define OBJECT_LIGHT_COUNT " + std::to_string(count) + "u\n";
+
+        if (bucket == 1 || Nova::CONST::OBJECT_LIGHT_BUCKETS[bucket - 2] + 1 == count)
+        {
+            defines += "#define OBJECT_LIGHT_COUNT_EXACT\n";
+        }
+    }
+
+    return defines;
+}
+
+//Parallel shader compilation is an extension glad was generated without, so its pieces are declared here
+//The KHR and ARB versions share their values and entry point signature
+static constexpr GLenum MAX_SHADER_COMPILER_THREADS = 0x91B0;
+static constexpr GLenum COMPLETION_STATUS = 0x91B1;
+typedef void (APIENTRYP MaxShaderCompilerThreadsProc)(GLuint count);
+
+static bool hasExtension(const char* name)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+
+    for (GLint i = 0; i < count; ++i)
+    {
+        if (std::strcmp(reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i)), name) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static const GLenum STAGE_TYPES[3] = { GL_VERTEX_SHADER, GL_GEOMETRY_SHADER, GL_FRAGMENT_SHADER };
+
+//Creates a shader object and issues its compile, nothing here waits for the compiler
+static Nova::UInt compileStage(GLenum type, const Nova::String& source)
+{
+    const char* code = source.c_str();
+    Nova::UInt shader = glCreateShader(type);
+    glShaderSource(shader, 1, &code, NULL);
+    glCompileShader(shader);
+
+    return shader;
+}
+
+//Creates the build's program from its stages and issues the link
+static void linkBuild(Nova::ProgramBuild& build)
+{
+    build.program = glCreateProgram();
+    glProgramParameteri(build.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+    for (Nova::UInt stage : build.stages)
+    {
+        if (stage != 0)
+        {
+            glAttachShader(build.program, stage);
+        }
+    }
+
+    glLinkProgram(build.program);
+}
+
 Nova::Shader::Shader()
 {
     //TODO: Make program an optional value
@@ -59,65 +173,173 @@ Nova::Int Nova::Shader::init(Nova::String vertexFilename, Nova::String geometryF
     return 0;
 }
 
+Nova::Int Nova::Shader::init(const Nova::ShaderInfo& shaderInfo)
+{
+    info = shaderInfo;
+
+    compileShaders();
+
+    return 0;
+}
+
 Nova::Int Nova::Shader::compileShaders()
 {
-    const char* temp;
-    GLuint vertexShader, geometryShader, fragmentShader;
-    program = glCreateProgram();
+    //A build already on its way would be overtaken by this one and then swap in the older program
+    if (build)
+    {
+        std::cerr << "WARNING: Shader is still building, the new build was skipped: " << info.fragmentPath << std::endl;
+        return -1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
 
     std::cout << "Starting shader compilation for files: " << std::endl
         << "\tVertex:   " << info.vertexPath << std::endl
         << "\tGeometry: " << info.geometryPath << std::endl
-        << "\tFragment: " << info.fragmentPath << std::endl;
+        << "\tFragment: " << info.fragmentPath << std::endl
+        << "\tFeatures: " << info.features << std::endl;
 
-    //Create shaders
-    std::string vertexCode = readFileToString(info.vertexPath);
-    vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    temp = vertexCode.c_str();
-    glShaderSource(vertexShader, 1, &temp, NULL);
-    glCompileShader(vertexShader);
-    checkCompileErrors(vertexShader, "SHADER");
-    glAttachShader(program, vertexShader);
+    //Every stage gets the same defines, so the stages of a variant always agree
+    Nova::String defines = Nova::shaderDefines(info.features);
+    const Nova::String* paths[3] = { &info.vertexPath, &info.geometryPath, &info.fragmentPath };
 
-    if (!info.geometryPath.empty())
+    auto newBuild = std::make_shared<Nova::ProgramBuild>();
+    newBuild->program = 0;
+    newBuild->sharedStages = false;
+    newBuild->start = start;
+    newBuild->done = false;
+    sourceFiles.clear();
+
+    //Stages shared between programs, like vertex.vert, are read and expanded once
+    for (Nova::UInt i = 0; i < 3; ++i)
     {
-        std::string geometryCode = readFileToString(info.geometryPath);
-        geometryShader = glCreateShader(GL_GEOMETRY_SHADER);
-        temp = geometryCode.c_str();
-        glShaderSource(geometryShader, 1, &temp, NULL);
-        glCompileShader(geometryShader);
-        checkCompileErrors(geometryShader, "SHADER");
-        glAttachShader(program, geometryShader);
-    }
+        newBuild->stages[i] = 0;
+        newBuild->stageKeys[i] = 0;
 
-    std::string fragmentCode = readFileToString(info.fragmentPath);
-    fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    temp = fragmentCode.c_str();
-    glShaderSource(fragmentShader, 1, &temp, NULL);
-    glCompileShader(fragmentShader);
-    checkCompileErrors(fragmentShader, "SHADER");
-    glAttachShader(program, fragmentShader);
-   
+        if (paths[i]->empty())
+        {
+            continue;
+        }
+
+        const Nova::ShaderSource& source = shaderSources.expand(*paths[i], defines);
+        newBuild->sources[i] = source.code;
+        newBuild->stageKeys[i] = Nova::hashBytes(&STAGE_TYPES[i], sizeof(GLenum), source.hash);
+        newBuild->stageFiles[i] = source.files;
 
-    glLinkProgram(program);
-    checkCompileErrors(program, "PROGRAM");
+        for (const auto& file : source.files)
+        {
+            if (std::find(sourceFiles.begin(), sourceFiles.end(), file) == sourceFiles.end())
+            {
+                sourceFiles.push_back(file);
+            }
+        }
+    }
 
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    //Programs are cached by their final sources, a hit skips compiling and linking entirely
+    newBuild->cacheKey = programCache.makeKey({ newBuild->sources[0], newBuild->sources[1], newBuild->sources[2] });
+    Nova::UInt cached = programCache.load(newBuild->cacheKey);
 
-    if (!info.geometryPath.empty())
+    if (cached != 0)
     {
-        glDeleteShader(geometryShader);
+        swapProgram(cached);
+        programCache.record(true, std::chrono::duration<Nova::Float, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+        std::cout << "Loaded shader program from the cache." << std::endl;
+
+        return 0;
     }
 
-    std::cout << "Completed shader compilation." << std::endl;
+    build = newBuild;
+    shaderManager.submit(build);
 
     return 0;
 }
 
+bool Nova::Shader::updateBuild()
+{
+    if (!build || !shaderManager.isComplete(*build))
+    {
+        return false;
+    }
+
+    //Errors are only read now, asking any earlier would wait for the compiler
+    for (Nova::UInt i = 0; i < 3; ++i)
+    {
+        GLint compiled = GL_TRUE;
+        if (build->stages[i] != 0)
+        {
+            glGetShaderiv(build->stages[i], GL_COMPILE_STATUS, &compiled);
+        }
+
+        if (compiled == GL_FALSE)
+        {
+            checkCompileErrors(build->stages[i], "SHADER");
+
+            //Errors name a source string, which is the file's index here
+            for (Nova::UInt file = 0; file < build->stageFiles[i].size(); ++file)
+            {
+                std::cout << "\tSource " << file << ": " << build->stageFiles[i][file] << std::endl;
+            }
+        }
+    }
+
+    checkCompileErrors(build->program, "PROGRAM");
+
+    GLint linked = GL_FALSE;
+    glGetProgramiv(build->program, GL_LINK_STATUS, &linked);
+
+    //The linked program keeps its code, the stages are no longer needed by it
+    shaderManager.releaseStages(*build);
+
+    bool swapped = linked == GL_TRUE;
+    if (swapped)
+    {
+        //Only programs that linked are worth loading next time
+        programCache.save(build->cacheKey, build->program);
+        swapProgram(build->program);
+
+        std::cout << "Completed shader compilation: " << info.fragmentPath << std::endl;
+    }
+    else
+    {
+        glDeleteProgram(build->program);
+        std::cerr << "ERROR: Shader build failed, the previous program stays in use: " << info.fragmentPath << std::endl;
+    }
+
+    programCache.record(false, std::chrono::duration<Nova::Float, std::milli>(std::chrono::steady_clock::now() - build->start).count());
+    build.reset();
+
+    return swapped;
+}
+
+void Nova::Shader::swapProgram(Nova::UInt newProgram)
+{
+    if (isReady())
+    {
+        Nova::glState.forgetProgram(program);
+        glDeleteProgram(program);
+    }
+
+    program = newProgram;
+    reflectUniforms();
+}
+
+bool Nova::Shader::isReady() const
+{
+    return program != static_cast<GLuint>(-1);
+}
+
+bool Nova::Shader::isBuilding() const
+{
+    return build != nullptr;
+}
+
 Nova::Shader::~Shader()
 {
-    glDeleteProgram(program);
+    if (isReady())
+    {
+        glDeleteProgram(program);
+    }
 }
 
 GLuint Nova::Shader::getProgram(void)
@@ -125,24 +347,536 @@ GLuint Nova::Shader::getProgram(void)
 	return program;
 }
 
-Nova::ShaderManager::ShaderManager() {}
+const Nova::ShaderInfo& Nova::Shader::getInfo() const
+{
+    return info;
+}
+
+Nova::Array<Nova::String> Nova::Shader::getSourcePaths() const
+{
+    return sourceFiles;
+}
+
+//Binary search over a reflected table, returns -1 when the name is not present
+static Nova::Int findEntry(const Nova::Array<Nova::UniformEntry>& entries, Nova::UInt nameHash)
+{
+    auto it = std::lower_bound(entries.begin(), entries.end(), nameHash,
+        [](const Nova::UniformEntry& entry, Nova::UInt hash) { return entry.hash < hash; });
+
+    if (it == entries.end() || it->hash != nameHash)
+    {
+        return -1;
+    }
+
+    return it->location;
+}
+
+//Sorts a reflected table by hash and reports any names that hash to the same value
+static void sortEntries(Nova::Array<Nova::UniformEntry>& entries)
+{
+    std::sort(entries.begin(), entries.end(),
+        [](const Nova::UniformEntry& a, const Nova::UniformEntry& b) { return a.hash < b.hash; });
+
+    for (size_t i = 1; i < entries.size(); ++i)
+    {
+        if (entries[i].hash == entries[i - 1].hash && entries[i].location != entries[i - 1].location)
+        {
+            std::cerr << "WARNING: Uniform name hash collision, hash: " << entries[i].hash << std::endl;
+        }
+    }
+}
+
+//Enumerates every active uniform and uniform block once so lookups never reach the driver
+void Nova::Shader::reflectUniforms()
+{
+    uniforms.clear();
+    uniformBlocks.clear();
+
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    Nova::String name(maxLength, '\0');
+    for (GLint i = 0; i < count; ++i)
+    {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(program, i, maxLength, &length, &size, &type, &name[0]);
+
+        //Uniforms inside blocks have no location
+        GLint location = glGetUniformLocation(program, name.c_str());
+        if (location < 0)
+        {
+            continue;
+        }
+
+        Nova::String uniformName = name.substr(0, length);
+        uniforms.push_back({ Nova::hashString(uniformName.c_str()), location });
+
+        //Arrays are reported as "name[0]", allow lookups by the bare name too
+        if (uniformName.size() > 3 && uniformName.compare(uniformName.size() - 3, 3, "[0]") == 0)
+        {
+            uniformName.resize(uniformName.size() - 3);
+            uniforms.push_back({ Nova::hashString(uniformName.c_str()), location });
+        }
+    }
+
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxLength);
+
+    name.assign(maxLength, '\0');
+    for (GLint i = 0; i < count; ++i)
+    {
+        GLsizei length = 0;
+        glGetActiveUniformBlockName(program, i, maxLength, &length, &name[0]);
+        uniformBlocks.push_back({ Nova::hashString(name.substr(0, length).c_str()), i });
+    }
+
+    sortEntries(uniforms);
+    sortEntries(uniformBlocks);
+}
+
+Nova::Int Nova::Shader::getUniformLocation(Nova::UInt nameHash) const
+{
+    return findEntry(uniforms, nameHash);
+}
+
+Nova::Int Nova::Shader::getUniformBlockIndex(Nova::UInt nameHash) const
+{
+    return findEntry(uniformBlocks, nameHash);
+}
+
+void Nova::Shader::setInt(Nova::UInt nameHash, Nova::Int value)
+{
+    ++Nova::frameStats.uniformLookupsSaved;
+    glProgramUniform1i(program, findEntry(uniforms, nameHash), value);
+}
+
+void Nova::Shader::setFloat(Nova::UInt nameHash, Nova::Float value)
+{
+    ++Nova::frameStats.uniformLookupsSaved;
+    glProgramUniform1f(program, findEntry(uniforms, nameHash), value);
+}
+
+void Nova::Shader::setVec3(Nova::UInt nameHash, const Nova::Vector3& value)
+{
+    ++Nova::frameStats.uniformLookupsSaved;
+    glProgramUniform3fv(program, findEntry(uniforms, nameHash), 1, value.data());
+}
+
+void Nova::Shader::setMat4(Nova::UInt nameHash, const Nova::Matrix4& value)
+{
+    ++Nova::frameStats.uniformLookupsSaved;
+    glProgramUniformMatrix4fv(program, findEntry(uniforms, nameHash), 1, GL_FALSE, value.data());
+}
+
+Nova::ShaderManager::ShaderManager()
+{
+    mode = Nova::ShaderCompileMode::SYNCHRONOUS;
+    stopping = false;
+    reloads = 0;
+    stageReuses = 0;
+}
+
+void Nova::ShaderManager::init(GLFWwindow* window)
+{
+    watcher.init();
+
+    const char* entryPoint = nullptr;
+    if (hasExtension("GL_KHR_parallel_shader_compile"))
+    {
+        entryPoint = "glMaxShaderCompilerThreadsKHR";
+    }
+    else if (hasExtension("GL_ARB_parallel_shader_compile"))
+    {
+        entryPoint = "glMaxShaderCompilerThreadsARB";
+    }
+
+    auto maxCompilerThreads = entryPoint ? reinterpret_cast<MaxShaderCompilerThreadsProc>(glfwGetProcAddress(entryPoint)) : nullptr;
+    if (maxCompilerThreads)
+    {
+        //All bits set lets the driver pick its own thread count
+        maxCompilerThreads(0xFFFFFFFF);
+        mode = Nova::ShaderCompileMode::DRIVER_PARALLEL;
+
+        GLint threads = 0;
+        glGetIntegerv(MAX_SHADER_COMPILER_THREADS, &threads);
+        std::cout << "Shaders build on the driver's compiler threads (" << entryPoint << ", limit " << threads << ")" << std::endl;
+
+        return;
+    }
+
+    //Hidden windows are only made for their contexts, which share programs with the main one
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    for (Nova::UInt i = 0; i < Nova::CONST::SHADER_COMPILE_WORKERS; ++i)
+    {
+        GLFWwindow* context = glfwCreateWindow(1, 1, "Nova Shader Worker", NULL, window);
+        if (context == NULL)
+        {
+            break;
+        }
+
+        contexts.push_back(context);
+    }
+    glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+
+    //Creating a window may have changed the current context
+    glfwMakeContextCurrent(window);
+
+    if (contexts.empty())
+    {
+        std::cerr << "WARNING: No shader worker contexts could be created, shaders will build on the main thread." << std::endl;
+        return;
+    }
+
+    mode = Nova::ShaderCompileMode::WORKER_CONTEXTS;
+    stopping = false;
+
+    for (GLFWwindow* context : contexts)
+    {
+        workers.emplace_back(&Nova::ShaderManager::workerLoop, this, context);
+    }
+
+    std::cout << "Shaders build on " << contexts.size() << " worker contexts" << std::endl;
+}
+
+void Nova::ShaderManager::shutdown()
+{
+    watcher.shutdown();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    for (GLFWwindow* context : contexts)
+    {
+        glfwDestroyWindow(context);
+    }
+
+    workers.clear();
+    contexts.clear();
+    queue.clear();
+    mode = Nova::ShaderCompileMode::SYNCHRONOUS;
+}
+
+void Nova::ShaderManager::workerLoop(GLFWwindow* context)
+{
+    glfwMakeContextCurrent(context);
+
+    while (true)
+    {
+        std::shared_ptr<Nova::ProgramBuild> build;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || !queue.empty(); });
+
+            if (stopping)
+            {
+                break;
+            }
+
+            build = queue.front();
+            queue.pop_front();
+        }
+
+        for (Nova::UInt i = 0; i < 3; ++i)
+        {
+            build->stages[i] = build->sources[i].empty() ? 0 : compileStage(STAGE_TYPES[i], build->sources[i]);
+        }
+
+        linkBuild(*build);
+
+        //Another context may only rely on the program once this one has finished building it
+        glFinish();
+        build->done = true;
+    }
+
+    glfwMakeContextCurrent(NULL);
+}
+
+template<typename Fn>
+void Nova::ShaderManager::forEachShader(Fn fn)
+{
+    for (auto shaderRef : shaders)
+    {
+        fn(shaderRef.get());
+    }
+
+    for (auto& [base, shaderVariants] : variants)
+    {
+        for (auto& [features, variant] : shaderVariants)
+        {
+            fn(*variant);
+        }
+    }
+}
 
 bool Nova::ShaderManager::addShader(Nova::Shader& shader)
 {
     shaders.push_back(shader);
+    track(shader);
 
     return true;
 }
 
+void Nova::ShaderManager::track(Nova::Shader& shader)
+{
+    for (const auto& path : shader.getSourcePaths())
+    {
+        auto& readers = dependents[watcher.watch(path)];
+        if (std::find(readers.begin(), readers.end(), &shader) == readers.end())
+        {
+            readers.push_back(&shader);
+        }
+    }
+}
+
 void Nova::ShaderManager::recompileShaders()
 {
+    //The watcher can miss edits, so a manual recompile always reads the files again
+    shaderSources.clear();
+
+    //Queued like a hot reload, so shaders still building are rebuilt once they finish instead of skipped
+    //Every build is started on the next update before any is waited on, so they all compile at once
+    forEachShader([this](Nova::Shader& shader) { stale.insert(&shader); });
+}
+
+void Nova::ShaderManager::update()
+{
+    //Only the shaders reading a changed file are rebuilt, along with their variants
+    for (const auto& path : watcher.takeChanged())
+    {
+        auto it = dependents.find(path);
+        if (it == dependents.end())
+        {
+            continue;
+        }
+
+        std::cout << "Shader file changed: " << path << std::endl;
+        shaderSources.invalidate(path);
+
+        for (Nova::Shader* shader : it->second)
+        {
+            stale.insert(shader);
+
+            auto shaderVariants = variants.find(shader);
+            if (shaderVariants != variants.end())
+            {
+                for (auto& [features, variant] : shaderVariants->second)
+                {
+                    stale.insert(variant.get());
+                }
+            }
+        }
+    }
+
+    for (auto it = stale.begin(); it != stale.end();)
+    {
+        if ((*it)->isBuilding())
+        {
+            ++it;
+            continue;
+        }
+
+        //An edit may have added includes, which are watched from now on
+        (*it)->compileShaders();
+        track(**it);
+        ++reloads;
+        it = stale.erase(it);
+    }
+
+    //Swapping only forgets the replaced program, the rest of the bound state stays valid
+    forEachShader([](Nova::Shader& shader) { shader.updateBuild(); });
+}
+
+void Nova::ShaderManager::waitForBuilds()
+{
+    update();
+
+    while (getBuildingCount() > 0)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        update();
+    }
+}
+
+void Nova::ShaderManager::submit(const std::shared_ptr<Nova::ProgramBuild>& build)
+{
+    if (mode == Nova::ShaderCompileMode::WORKER_CONTEXTS)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back(build);
+        }
+        wake.notify_one();
+
+        return;
+    }
+
+    //Builds issued here share stage objects, a stage compiled for one program is attached to the next as is
+    build->sharedStages = true;
+    for (Nova::UInt i = 0; i < 3; ++i)
+    {
+        build->stages[i] = build->sources[i].empty() ? 0 : acquireStage(*build, i);
+    }
+
+    linkBuild(*build);
+
+    if (mode == Nova::ShaderCompileMode::SYNCHRONOUS)
+    {
+        build->done = true;
+    }
+}
+
+Nova::UInt Nova::ShaderManager::acquireStage(const Nova::ProgramBuild& build, Nova::UInt stage)
+{
+    auto it = stageObjects.find(build.stageKeys[stage]);
+    if (it != stageObjects.end())
+    {
+        ++it->second.users;
+        ++stageReuses;
+
+        return it->second.shader;
+    }
+
+    Nova::UInt shader = compileStage(STAGE_TYPES[stage], build.sources[stage]);
+    stageObjects[build.stageKeys[stage]] = { shader, 1 };
+
+    return shader;
+}
+
+void Nova::ShaderManager::releaseStages(Nova::ProgramBuild& build)
+{
+    for (Nova::UInt i = 0; i < 3; ++i)
+    {
+        if (build.stages[i] == 0)
+        {
+            continue;
+        }
+
+        if (!build.sharedStages)
+        {
+            glDeleteShader(build.stages[i]);
+            continue;
+        }
+
+        //Once no build in flight uses a stage, a later build with the same source compiles it again
+        auto it = stageObjects.find(build.stageKeys[i]);
+        if (it != stageObjects.end() && --it->second.users == 0)
+        {
+            glDeleteShader(it->second.shader);
+            stageObjects.erase(it);
+        }
+    }
+}
+
+bool Nova::ShaderManager::isComplete(const Nova::ProgramBuild& build) const
+{
+    if (mode == Nova::ShaderCompileMode::DRIVER_PARALLEL)
+    {
+        GLint complete = GL_FALSE;
+        glGetProgramiv(build.program, COMPLETION_STATUS, &complete);
+
+        return complete == GL_TRUE;
+    }
+
+    return build.done;
+}
+
+Nova::Shader& Nova::ShaderManager::getVariant(Nova::Shader& shader, Nova::UInt features)
+{
+    if (features == 0)
+    {
+        return shader;
+    }
+
+    auto& shaderVariants = variants[&shader];
+    auto it = shaderVariants.find(features);
+
+    if (it == shaderVariants.end())
+    {
+        Nova::ShaderInfo variantInfo = shader.getInfo();
+        variantInfo.features = features;
+
+        auto variant = std::make_unique<Nova::Shader>();
+        variant->init(variantInfo);
+
+        it = shaderVariants.emplace(features, std::move(variant)).first;
+    }
+
+    if (it->second->isReady())
+    {
+        return *it->second;
+    }
+
+    //Objects keep drawing with the generic program until their variant is built
+    //Baked mode binds no light lists, so a baked request only falls back to the plain baked variant, built at startup
+    Nova::UInt required = features & Nova::ShaderFeature::BAKED_LIGHTING;
+    if (required != 0 && required != features)
+    {
+        return getVariant(shader, required);
+    }
+
+    return shader;
+}
+
+Nova::UInt Nova::ShaderManager::getVariantCount() const
+{
+    Nova::UInt count = 0;
+    for (const auto& [base, shaderVariants] : variants)
+    {
+        count += shaderVariants.size();
+    }
+
+    return count;
+}
+
+Nova::UInt Nova::ShaderManager::getBuildingCount() const
+{
+    Nova::UInt count = 0;
     for (auto shaderRef : shaders)
     {
-        auto& shader = shaderRef.get();
+        count += shaderRef.get().isBuilding();
+    }
 
-        glDeleteProgram(shader.getProgram());
-        shader.compileShaders();
+    for (const auto& [base, shaderVariants] : variants)
+    {
+        for (const auto& [features, variant] : shaderVariants)
+        {
+            count += variant->isBuilding();
+        }
     }
+
+    return count;
+}
+
+Nova::ShaderCompileMode Nova::ShaderManager::getCompileMode() const
+{
+    return mode;
+}
+
+Nova::UInt Nova::ShaderManager::getWatchedFileCount()
+{
+    return watcher.getWatchedCount();
+}
+
+Nova::UInt Nova::ShaderManager::getReloadCount() const
+{
+    return reloads;
+}
+
+Nova::UInt Nova::ShaderManager::getStageReuseCount() const
+{
+    return stageReuses;
 }
 
 Nova::Array<Nova::ShaderProgram> Nova::ShaderManager::getShaderPrograms()
@@ -0,0 +1,168 @@
+#include <Nova/shader_source.hpp>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <filesystem>
+
+#include <Nova/utils.hpp>
+
+Nova::ShaderSourceCache::ShaderSourceCache()
+{
+	filesRead = 0;
+	expansions = 0;
+	hits = 0;
+}
+
+const Nova::ShaderSource& Nova::ShaderSourceCache::expand(const Nova::String& path, const Nova::String& defines)
+{
+	Nova::String normal = Nova::normalizePath(path);
+
+	//The separator keeps a path ending in a define's text from matching another pair
+	Nova::UInt64 key = Nova::hashBytes(normal.data(), normal.size());
+	key = Nova::hashBytes("", 1, key);
+	key = Nova::hashBytes(defines.data(), defines.size(), key);
+
+	auto it = expanded.find(key);
+	if (it != expanded.end())
+	{
+		++hits;
+		return it->second;
+	}
+
+	Nova::ShaderSource source;
+	expandFile(normal, defines, source);
+	source.hash = Nova::hashBytes(source.code.data(), source.code.size());
+	++expansions;
+
+	return expanded.emplace(key, std::move(source)).first->second;
+}
+
+void Nova::ShaderSourceCache::invalidate(const Nova::String& path)
+{
+	files.erase(path);
+
+	for (auto it = expanded.begin(); it != expanded.end();)
+	{
+		const auto& sourceFiles = it->second.files;
+		if (std::find(sourceFiles.begin(), sourceFiles.end(), path) != sourceFiles.end())
+		{
+			it = expanded.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+void Nova::ShaderSourceCache::clear()
+{
+	files.clear();
+	expanded.clear();
+}
+
+Nova::UInt Nova::ShaderSourceCache::getFilesRead() const
+{
+	return filesRead;
+}
+
+Nova::UInt Nova::ShaderSourceCache::getExpansions() const
+{
+	return expansions;
+}
+
+Nova::UInt Nova::ShaderSourceCache::getHits() const
+{
+	return hits;
+}
+
+const Nova::String* Nova::ShaderSourceCache::readFile(const Nova::String& path)
+{
+	auto it = files.find(path);
+	if (it != files.end())
+	{
+		return &it->second;
+	}
+
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+	{
+		return nullptr;
+	}
+
+	std::stringstream contents;
+	contents << file.rdbuf();
+
+	//Line endings are made uniform so files saved on any platform expand the same way
+	Nova::String text = contents.str();
+	text.erase(std::remove(text.begin(), text.end(), '\r'), text.end());
+	++filesRead;
+
+	return &files.emplace(path, std::move(text)).first->second;
+}
+
+void Nova::ShaderSourceCache::expandFile(const Nova::String& path, const Nova::String& defines, Nova::ShaderSource& source)
+{
+	Nova::UInt index = static_cast<Nova::UInt>(source.files.size());
+
+	//Missing files are still listed, so they are watched and the stage rebuilds once they exist
+	source.files.push_back(path);
+
+	const Nova::String* contents = readFile(path);
+	if (contents == nullptr)
+	{
+		std::cerr << "ERROR: Shader file could not be read: " << path << std::endl;
+		return;
+	}
+
+	//Included files count their lines from one under their own source string
+	if (index > 0)
+	{
+		source.code += "#line 1 " + std::to_string(index) + "\n";
+	}
+
+	std::istringstream stream(*contents);
+	Nova::String line;
+	Nova::UInt lineNumber = 0;
+
+	while (std::getline(stream, line))
+	{
+		++lineNumber;
+		std::size_t start = line.find_first_not_of(" \t");
+
+		if (index == 0 && start != Nova::String::npos && line.compare(start, 8, "#version") == 0)
+		{
+			source.code += line + "\n" + defines + "#line " + std::to_string(lineNumber + 1) + " 0\n";
+			continue;
+		}
+
+		if (start == Nova::String::npos || line.compare(start, 8, "#include") != 0)
+		{
+			source.code += line + "\n";
+			continue;
+		}
+
+		//A malformed include is passed through, so the compiler reports it at its line
+		std::size_t open = line.find('"', start);
+		std::size_t close = (open == Nova::String::npos) ? Nova::String::npos : line.find('"', open + 1);
+		if (close == Nova::String::npos)
+		{
+			source.code += line + "\n";
+			continue;
+		}
+
+		Nova::String included = Nova::normalizePath((std::filesystem::path(path).parent_path() / line.substr(open + 1, close - open - 1)).string());
+
+		//Files already in this stage become a blank line, which also stops include cycles
+		if (std::find(source.files.begin(), source.files.end(), included) != source.files.end())
+		{
+			source.code += "\n";
+			continue;
+		}
+
+		expandFile(included, defines, source);
+		source.code += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(index) + "\n";
+	}
+}
\ No newline at end of file
@@ -0,0 +1,325 @@
+#include <Nova/shadows.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <iostream>
+#include <glad/glad.h>
+
+#include <Nova/engine.hpp>
+#include <Nova/utils.hpp>
+#include <Nova/culling.hpp>
+
+//Uniform names used by the shadow pass, hashed at compile time
+static constexpr Nova::UInt LIGHT_VIEW_PROJ_HASH = Nova::hashString("lightViewProj");
+
+static_assert(Nova::CONST::SHADOW_CASCADES == 4, "Cascade splits are packed into one vec4");
+
+
+Nova::ShadowMaps::ShadowMaps()
+{
+	size = 0;
+	framebuffer = shadowMap = staticMap = 0;
+	staticVersion = 0;
+	visibleCapacity = 0;
+
+	for (Nova::UInt i = 0; i < Nova::CONST::SHADOW_CASCADES; ++i)
+	{
+		cascades[i].viewProj = Nova::Matrix4::Identity();
+		cascades[i].staticValid = false;
+		cascades[i].renderedValid = false;
+		data.cascadeViewProj[i] = Nova::Matrix4::Identity();
+	}
+
+	data.cascadeSplits.setZero();
+	data.direction.setZero();
+	data.ambient.setZero();
+	data.diffuse.setZero();
+	data.specular.setZero();
+}
+
+void Nova::ShadowMaps::init(Nova::Int size)
+{
+	this->size = size;
+
+	//The final maps are sampled with hardware comparison, the static cache is only ever copied from
+	glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &shadowMap);
+	glTextureStorage3D(shadowMap, 1, GL_DEPTH_COMPONENT32F, size, size, Nova::CONST::SHADOW_CASCADES);
+	glTextureParameteri(shadowMap, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTextureParameteri(shadowMap, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTextureParameteri(shadowMap, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+	glTextureParameteri(shadowMap, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+
+	//Anything outside a cascade is lit
+	const Nova::Float border[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	glTextureParameteri(shadowMap, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+	glTextureParameteri(shadowMap, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+	glTextureParameterfv(shadowMap, GL_TEXTURE_BORDER_COLOR, border);
+
+	glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &staticMap);
+	glTextureStorage3D(staticMap, 1, GL_DEPTH_COMPONENT32F, size, size, Nova::CONST::SHADOW_CASCADES);
+
+	//Layers are attached as each cascade is drawn, there is never a color output
+	glCreateFramebuffers(1, &framebuffer);
+	glNamedFramebufferDrawBuffer(framebuffer, GL_NONE);
+	glNamedFramebufferReadBuffer(framebuffer, GL_NONE);
+}
+
+void Nova::ShadowMaps::destroy()
+{
+	const Nova::UInt textures[] = { shadowMap, staticMap };
+	glDeleteTextures(2, textures);
+	glDeleteFramebuffers(1, &framebuffer);
+
+	framebuffer = shadowMap = staticMap = 0;
+	for (auto& cascade : cascades)
+	{
+		cascade.staticValid = false;
+		cascade.renderedValid = false;
+	}
+
+	glState.invalidate();
+}
+
+void Nova::ShadowMaps::update(const Nova::Matrix4& view, const Nova::Matrix4& proj, Nova::Float zNear, Nova::Float zFar, const Nova::Vector3& direction)
+{
+	//Split the shadowed range between uniform and logarithmic spacing
+	Nova::Float shadowFar = std::min(zFar, Nova::CONST::SHADOW_DISTANCE);
+	Nova::Float splits[Nova::CONST::SHADOW_CASCADES + 1];
+	splits[0] = zNear;
+
+	for (Nova::UInt i = 1; i <= Nova::CONST::SHADOW_CASCADES; ++i)
+	{
+		Nova::Float t = static_cast<Nova::Float>(i) / Nova::CONST::SHADOW_CASCADES;
+		Nova::Float logSplit = zNear * std::pow(shadowFar / zNear, t);
+		Nova::Float uniformSplit = zNear + (shadowFar - zNear) * t;
+
+		splits[i] = Nova::CONST::SHADOW_SPLIT_LAMBDA * logSplit + (1.0f - Nova::CONST::SHADOW_SPLIT_LAMBDA) * uniformSplit;
+		data.cascadeSplits[i - 1] = splits[i];
+	}
+
+	//Slope of the frustum sides, the squared length of a corner per unit of depth
+	Nova::Float tanX = 1.0f / proj(0, 0);
+	Nova::Float tanY = 1.0f / proj(1, 1);
+	Nova::Float cornerSlope = tanX * tanX + tanY * tanY;
+
+	Nova::Vector3 lightDir = direction.normalized();
+	Nova::Vector3 up = std::abs(lightDir.y()) > 0.99f ? Nova::Vector3(0.0f, 0.0f, 1.0f) : Nova::Vector3(0.0f, 1.0f, 0.0f);
+	Nova::Matrix4 lightView = Nova::lookAt(Nova::Vector3::Zero(), lightDir, up);
+	Nova::Matrix4 invView = view.inverse();
+
+	for (Nova::UInt i = 0; i < Nova::CONST::SHADOW_CASCADES; ++i)
+	{
+		Nova::Float n = splits[i];
+		Nova::Float f = splits[i + 1];
+
+		//The smallest sphere around the slice only depends on the camera lens, so its radius never changes while the camera moves
+		Nova::Float centerDepth = std::min(f, 0.5f * (n + f) * (1.0f + cornerSlope));
+		Nova::Float radius = std::sqrt((f - centerDepth) * (f - centerDepth) + f * f * cornerSlope);
+
+		Nova::Vector4 center = lightView * invView * Nova::Vector4(0.0f, 0.0f, -centerDepth, 1.0f);
+
+		//Move the cascade in whole texel steps, small camera movements then leave the matrix unchanged
+		Nova::Float halfExtent = radius * (1.0f + Nova::CONST::SHADOW_SNAP_FRACTION);
+		Nova::Float texel = 2.0f * halfExtent / size;
+		Nova::Float step = std::max(texel, std::floor(radius * Nova::CONST::SHADOW_SNAP_FRACTION / texel) * texel);
+
+		Nova::Float x = std::floor(center.x() / step) * step;
+		Nova::Float y = std::floor(center.y() / step) * step;
+		Nova::Float z = std::floor(center.z() / step) * step;
+
+		//Light space looks down -z, casters up to the extrusion distance toward the light still shadow the slice
+		Nova::Matrix4 lightProj = Nova::makeOrthographic(
+			x - halfExtent, x + halfExtent, y - halfExtent, y + halfExtent,
+			-(z + step + radius + Nova::CONST::SHADOW_CASTER_EXTRUSION), -(z - radius));
+
+		cascades[i].viewProj = lightProj * lightView;
+		data.cascadeViewProj[i] = cascades[i].viewProj;
+	}
+
+	data.direction << lightDir, 1.0f;
+}
+
+void Nova::ShadowMaps::render(const Nova::Array<Nova::ShadowCaster>& casters, const Nova::Array<Nova::Vector4>& spheres)
+{
+	if (visibleCapacity < casters.size())
+	{
+		visibleCapacity = casters.size();
+		visible.reset(new bool[visibleCapacity]);
+	}
+
+	bool bound = false;
+	for (Nova::UInt i = 0; i < Nova::CONST::SHADOW_CASCADES; ++i)
+	{
+		Cascade& cascade = cascades[i];
+
+		Nova::Frustum frustum = Nova::extractFrustum(cascade.viewProj);
+		Nova::cullSpheres(frustum, spheres.data(), spheres.size(), visible.get());
+
+		staticDraws.clear();
+		dynamicDraws.clear();
+
+		//Identifies the set of dynamic casters the cascade was drawn with
+		Nova::UInt64 dynamicHash = Nova::CONST::FNV_OFFSET_BASIS;
+		for (Nova::UInt j = 0; j < casters.size(); ++j)
+		{
+			if (!visible[j])
+			{
+				continue;
+			}
+
+			if (casters[j].isStatic)
+			{
+				staticDraws.push_back(j);
+				continue;
+			}
+
+			dynamicDraws.push_back(j);
+			dynamicHash = Nova::hashBytes(casters[j].model->data(), sizeof(Nova::Matrix4), dynamicHash);
+			dynamicHash = Nova::hashBytes(&casters[j].mesh->firstIndex, sizeof(Nova::UInt), dynamicHash);
+			dynamicHash = Nova::hashBytes(&casters[j].mesh->baseVertex, sizeof(Nova::UInt), dynamicHash);
+		}
+
+		bool staticChanged = !cascade.staticValid || cascade.staticVersion != staticVersion || cascade.staticViewProj != cascade.viewProj;
+		bool changed = staticChanged || !cascade.renderedValid || cascade.renderedStaticVersion != staticVersion
+			|| cascade.renderedViewProj != cascade.viewProj || cascade.dynamicHash != dynamicHash;
+
+		if (!changed)
+		{
+			++frameStats.shadowCascadesSkipped;
+			continue;
+		}
+
+		if (!bound)
+		{
+			glState.bindFramebuffer(framebuffer);
+			glState.setViewport(0, 0, size, size);
+			glState.setDepthTest(true);
+			glState.setDepthMask(true);
+			glState.setDepthFunc(GL_LESS);
+			glState.useProgram(shadowShader.getProgram());
+			glState.bindVertexArray(meshPool.getVAO());
+
+			//Slope scaled bias keeps surfaces from shadowing themselves
+			glState.setPolygonOffset(true);
+			glState.setPolygonOffsetParams(2.0f, 4.0f);
+			bound = true;
+		}
+
+		shadowShader.setMat4(LIGHT_VIEW_PROJ_HASH, cascade.viewProj);
+
+		if (staticChanged)
+		{
+			drawCasters(staticMap, i, casters, staticDraws);
+
+			cascade.staticViewProj = cascade.viewProj;
+			cascade.staticVersion = staticVersion;
+			cascade.staticValid = true;
+			++frameStats.shadowStaticRefreshes;
+		}
+
+		//Start from the cached statics and add the objects that move
+		glCopyImageSubData(staticMap, GL_TEXTURE_2D_ARRAY, 0, 0, 0, i,
+			shadowMap, GL_TEXTURE_2D_ARRAY, 0, 0, 0, i, size, size, 1);
+
+		drawCasters(shadowMap, i, casters, dynamicDraws);
+
+		cascade.renderedViewProj = cascade.viewProj;
+		cascade.renderedStaticVersion = staticVersion;
+		cascade.dynamicHash = dynamicHash;
+		cascade.renderedValid = true;
+		++frameStats.shadowCascadesRendered;
+	}
+
+	if (bound)
+	{
+		glState.setPolygonOffset(false);
+		glState.bindFramebuffer(0);
+		glState.setViewport(static_cast<Nova::Int>(frameConstants.viewport.x()), static_cast<Nova::Int>(frameConstants.viewport.y()),
+			static_cast<Nova::Int>(frameConstants.viewport.z()), static_cast<Nova::Int>(frameConstants.viewport.w()));
+	}
+}
+
+void Nova::ShadowMaps::drawCasters(Nova::UInt texture, Nova::UInt layer, const Nova::Array<Nova::ShadowCaster>& casters, Nova::Array<Nova::UInt>& draws)
+{
+	static Nova::Array<Nova::DrawElementsIndirectCommand> commands;
+	static Nova::Array<Nova::InstanceData> instances;
+
+	glNamedFramebufferTextureLayer(framebuffer, GL_DEPTH_ATTACHMENT, texture, 0, layer);
+
+	//The static cache starts empty, the final map was just filled by the copy
+	if (texture == staticMap)
+	{
+		const Nova::Float clearDepth = 1.0f;
+		glClearNamedFramebufferfv(framebuffer, GL_DEPTH, 0, &clearDepth);
+	}
+
+	if (draws.empty())
+	{
+		return;
+	}
+
+	//Group casters by mesh so each mesh becomes one instanced command
+	std::sort(draws.begin(), draws.end(), [&casters](Nova::UInt a, Nova::UInt b)
+	{
+		return casters[a].mesh->firstIndex < casters[b].mesh->firstIndex
+			|| (casters[a].mesh->firstIndex == casters[b].mesh->firstIndex && casters[a].mesh->baseVertex < casters[b].mesh->baseVertex);
+	});
+
+	commands.clear();
+	instances.clear();
+
+	for (Nova::UInt i = 0; i < draws.size();)
+	{
+		const Nova::MeshInfo& mesh = *casters[draws[i]].mesh;
+
+		Nova::UInt end = i + 1;
+		while (end < draws.size() && casters[draws[end]].mesh->firstIndex == mesh.firstIndex
+			&& casters[draws[end]].mesh->baseVertex == mesh.baseVertex)
+		{
+			++end;
+		}
+
+		commands.push_back({ mesh.indexCount, end - i, mesh.firstIndex,
+			static_cast<Nova::Int>(mesh.baseVertex), static_cast<Nova::UInt>(instances.size()) });
+
+		//Depth only needs positions, the normal matrix is left empty
+		for (Nova::UInt j = i; j < end; ++j)
+		{
+			Nova::InstanceData& instance = instances.emplace_back();
+			instance.model = *casters[draws[j]].model;
+			instance.normal.setZero();
+		}
+
+		i = end;
+	}
+
+	//Each allocation is bound before the next one, a stream that grows drops older bindings
+	Nova::UInt instanceSize = sizeof(Nova::InstanceData) * instances.size();
+	Nova::UInt instanceOffset;
+	std::memcpy(instanceStream.allocate(instanceSize, instanceOffset), instances.data(), instanceSize);
+	glState.bindBufferRange(GL_SHADER_STORAGE_BUFFER, Nova::CONST::INSTANCE_DATA_BINDING, instanceStream.getBuffer(), instanceOffset, instanceSize);
+
+	Nova::UInt commandSize = sizeof(Nova::DrawElementsIndirectCommand) * commands.size();
+	Nova::UInt commandOffset;
+	std::memcpy(indirectStream.allocate(commandSize, commandOffset), commands.data(), commandSize);
+	glState.bindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectStream.getBuffer());
+
+	glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, reinterpret_cast<void*>(static_cast<std::uintptr_t>(commandOffset)), commands.size(), 0);
+}
+
+void Nova::ShadowMaps::markStaticDirty()
+{
+	++staticVersion;
+}
+
+const Nova::ShadowData& Nova::ShadowMaps::getData() const
+{
+	return data;
+}
+
+Nova::UInt Nova::ShadowMaps::getTexture() const
+{
+	return shadowMap;
+}
\ No newline at end of file
@@ -0,0 +1,167 @@
+#include <Nova/stream_buffer.hpp>
+
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+
+#include <Nova/engine.hpp>
+
+//How long a single fence wait blocks before checking again, in nanoseconds
+static constexpr GLuint64 FENCE_WAIT_TIMEOUT = 1000000;
+
+static Nova::UInt alignUp(Nova::UInt value, Nova::UInt alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+Nova::StreamBuffer::StreamBuffer()
+{
+	buffer = 0;
+	mapped = nullptr;
+	regionSize = regionCount = 0;
+	alignment = 1;
+	region = head = 0;
+}
+
+void Nova::StreamBuffer::init(Nova::UInt regionSize, Nova::UInt alignment, Nova::UInt regionCount)
+{
+	this->alignment = std::max(alignment, 1u);
+	this->regionSize = alignUp(regionSize, this->alignment);
+	this->regionCount = std::max(regionCount, 1u);
+
+	create();
+}
+
+void Nova::StreamBuffer::destroy()
+{
+	release();
+
+	regionSize = regionCount = 0;
+}
+
+void Nova::StreamBuffer::create()
+{
+	//Storage is immutable, so it stays mapped for the lifetime of the buffer
+	const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+	glCreateBuffers(1, &buffer);
+	glNamedBufferStorage(buffer, static_cast<GLsizeiptr>(regionSize) * regionCount, NULL, flags);
+	mapped = static_cast<Nova::UByte*>(glMapNamedBufferRange(buffer, 0, static_cast<GLsizeiptr>(regionSize) * regionCount, flags));
+
+	if (mapped == nullptr)
+	{
+		std::cerr << "ERROR: Could not map stream buffer." << std::endl;
+	}
+
+	fences.assign(regionCount, nullptr);
+	region = head = 0;
+}
+
+void Nova::StreamBuffer::release()
+{
+	for (auto& fence : fences)
+	{
+		if (fence != nullptr)
+		{
+			glDeleteSync(fence);
+		}
+	}
+	fences.clear();
+
+	if (buffer != 0)
+	{
+		//Deletion is deferred by the driver until the GPU stops reading the buffer
+		glUnmapNamedBuffer(buffer);
+		glDeleteBuffers(1, &buffer);
+
+		//Deleting a bound buffer resets its bindings
+		glState.invalidate();
+	}
+
+	buffer = 0;
+	mapped = nullptr;
+}
+
+void Nova::StreamBuffer::waitRegion(Nova::UInt region)
+{
+	GLsync& fence = fences[region];
+
+	if (fence == nullptr)
+	{
+		return;
+	}
+
+	//Most frames the region is already free, so poll once before timing anything
+	GLenum result = glClientWaitSync(fence, 0, 0);
+
+	if (result == GL_TIMEOUT_EXPIRED)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		do
+		{
+			result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_WAIT_TIMEOUT);
+		} while (result == GL_TIMEOUT_EXPIRED);
+
+		std::chrono::duration<Nova::Float, std::milli> waited = std::chrono::steady_clock::now() - start;
+		frameStats.fenceWaitTime += waited.count();
+		++frameStats.fenceWaits;
+	}
+
+	if (result == GL_WAIT_FAILED)
+	{
+		std::cerr << "WARNING: Stream buffer fence wait failed." << std::endl;
+	}
+
+	glDeleteSync(fence);
+	fence = nullptr;
+}
+
+void Nova::StreamBuffer::beginFrame()
+{
+	region = (region + 1) % regionCount;
+	head = 0;
+
+	waitRegion(region);
+}
+
+void Nova::StreamBuffer::endFrame()
+{
+	if (fences[region] != nullptr)
+	{
+		glDeleteSync(fences[region]);
+	}
+
+	fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void* Nova::StreamBuffer::allocate(Nova::UInt size, Nova::UInt& offset)
+{
+	Nova::UInt start = alignUp(head, alignment);
+
+	if (start + size > regionSize)
+	{
+		//Regions cannot be resized in place, so every region is replaced with a larger one
+		//The old buffer is orphaned, frames still in flight keep reading it until they finish
+		release();
+		regionSize = alignUp(std::max(regionSize * 2, size), alignment);
+		create();
+
+		start = 0;
+	}
+
+	head = start + size;
+	offset = region * regionSize + start;
+
+	return mapped + offset;
+}
+
+Nova::UInt Nova::StreamBuffer::getBuffer() const
+{
+	return buffer;
+}
+
+Nova::UInt Nova::StreamBuffer::getAlignment() const
+{
+	return alignment;
+}
\ No newline at end of file
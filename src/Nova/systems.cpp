@@ -1,5 +1,9 @@
 #include <Nova/systems.hpp>
 
+#include <algorithm>
+#include <cstring>
+#include <chrono>
+
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <Eigen/Core>
@@ -8,74 +12,575 @@
 #include <Nova/const.hpp>
 #include <Nova/engine.hpp>
 #include <Nova/utils.hpp>
+#include <Nova/render_queue.hpp>
+#include <Nova/culling.hpp>
+#include <Nova/clusters.hpp>
 
-void Nova::ObjectRenderSystem(flecs::iter& it)
+//Uniform names used by the render systems, hashed at compile time
+static constexpr Nova::UInt MODEL_HASH = Nova::hashString("model");
+static constexpr Nova::UInt LIGHT_COLOR_HASH = Nova::hashString("lightColor");
+
+//Per-draw data referenced by render queue items, only valid while the pass runs
+struct DrawData
+{
+    const Nova::Component::WorldTransform* transform;
+    const Nova::Component::Mesh* mesh;
+    const Nova::Component::PointLight* light;
+    const Nova::Component::WorldBounds* bounds;
+    Nova::Shader* shader;
+
+    //Texture array page the program samples, 0 when the draw binds its texture set instead
+    Nova::UInt textureArray;
+};
+
+//A run of indirect commands sharing a program and textures, drawn with a single multi-draw call
+struct DrawGroup
+{
+    Nova::UInt firstCommand;
+    Nova::UInt commandCount;
+    const Nova::Array<Nova::TextureInfo*>* textures;
+    Nova::UInt textureArray;
+    Nova::Shader* shader;
+};
+
+//Distance along the view direction normalized by the far plane, used for front-to-back ordering
+static Nova::Float viewDepth(const Nova::Matrix4& model)
+{
+    static auto cam = Nova::editorCamera.getCameraProperties();
+
+    return -Nova::frameConstants.view.row(2).dot(model.col(3)) / cam.zFar;
+}
+
+//The first texture identifies a texture set in sort keys, draws still compare the full set
+static Nova::UInt textureKey(const Nova::Component::Mesh& mesh)
+{
+    return mesh.textures.empty() ? 0 : mesh.textures[0]->texture;
+}
+
+//Draws on the same texture array page bind the same texture whatever their layers, others compare their texture sets
+static bool sameTextures(const DrawData& a, const DrawData& b)
+{
+    if (a.textureArray != b.textureArray)
+    {
+        return false;
+    }
+
+    return a.textureArray != 0 || a.mesh->textures == b.mesh->textures;
+}
+
+//Meshes are identified by their range in the mesh pool
+static bool sameMesh(const Nova::MeshInfo& a, const Nova::MeshInfo& b)
+{
+    return a.firstIndex == b.firstIndex && a.baseVertex == b.baseVertex && a.indexCount == b.indexCount;
+}
+
+//Draws a pool mesh without instancing
+static void drawMesh(const Nova::MeshInfo& mesh)
+{
+    Nova::glState.bindVertexArray(mesh.VAO);
+    glDrawElementsBaseVertex(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT,
+        (void*)(sizeof(Nova::UInt) * mesh.firstIndex), mesh.baseVertex);
+}
+
+//Binds every texture in the set to consecutive texture units
+static void bindTextures(const Nova::Array<Nova::TextureInfo*>& textures)
+{
+    for (int j = 0; j < textures.size(); ++j)
+    {
+        Nova::glState.bindTexture(j, textures[j]->texture);
+    }
+}
+
+//Forward shading uses the variant specialized for the object's textures and light count, other modes share one program
+//Objects with packed textures use the texture array variant of the program when texture arrays are on
+static Nova::Shader& objectShader(const Nova::Component::Mesh& mesh, Nova::UInt lightCount)
+{
+    bool packed = Nova::textureArrays && !mesh.textures.empty() && mesh.textures[0]->array != 0
+        && Nova::lightingMode != Nova::LightingMode::OVERDRAW;
+    Nova::UInt arrayFeature = packed ? Nova::ShaderFeature::TEXTURE_ARRAY : 0;
+
+    //The normal matrix benchmark shares forward.frag, it picks the same variants so only the vertex stage differs
+    bool forward = Nova::activeShader == &Nova::forwardShader || Nova::activeShader == &Nova::normalBenchShader;
+    if (!forward)
+    {
+        return Nova::shaderManager.getVariant(*Nova::activeShader, arrayFeature);
+    }
+
+    Nova::UInt features = (mesh.textures.empty() ? Nova::ShaderFeature::UNTEXTURED : 0) | arrayFeature;
+    if (Nova::lightingMode == Nova::LightingMode::BAKED)
+    {
+        features |= Nova::ShaderFeature::BAKED_LIGHTING;
+    }
+    else
+    {
+        features |= Nova::objectLightFeatures(lightCount);
+    }
+
+    return Nova::shaderManager.getVariant(*Nova::activeShader, features);
+}
+
+//Picks the strongest point lights reaching each instance, spread across the job system
+static void selectObjectLights(const Nova::Array<Nova::Vector4>& bounds, Nova::Array<Nova::ObjectLights>& objectLights)
+{
+    static Nova::Array<Nova::UInt> candidateCounts;
+
+    auto start = std::chrono::steady_clock::now();
+
+    objectLights.resize(bounds.size());
+    candidateCounts.resize(bounds.size());
+
+    Nova::jobSystem.parallelFor(bounds.size(), Nova::CONST::OBJECT_LIGHTS_PER_JOB, [&bounds, &objectLights](Nova::UInt begin, Nova::UInt end)
+    {
+        thread_local Nova::Array<Nova::UInt> candidates;
+
+        for (Nova::UInt i = begin; i < end; ++i)
+        {
+            candidateCounts[i] = Nova::lightManager.selectLights(bounds[i], objectLights[i], candidates);
+        }
+    });
+
+    std::chrono::duration<Nova::Float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    Nova::frameStats.lightSelectionTime = elapsed.count();
+
+    for (Nova::UInt i = 0; i < bounds.size(); ++i)
+    {
+        Nova::frameStats.objectLightCandidates += candidateCounts[i];
+        Nova::frameStats.objectLightRefs += objectLights[i].count;
+    }
+}
+
+void Nova::WorldTransformObserver(flecs::entity e, const Nova::Component::Transform& transform)
+{
+    e.set<Nova::Component::WorldTransform>(Nova::composeTransform(transform));
+}
+
+void Nova::WorldBoundsObserver(flecs::entity e, const Nova::Component::WorldTransform& transform, const Nova::Component::Mesh& mesh)
+{
+    e.set<Nova::Component::WorldBounds>({ Nova::transformSphere(transform.model, mesh.meshInfo.sphereCenter, mesh.meshInfo.sphereRadius) });
+
+    //Culling fills this in before anything is rendered
+    if (!e.has<Nova::Component::Visibility>())
+    {
+        e.set<Nova::Component::Visibility>({ true });
+    }
+}
+
+void Nova::PointLightChangeObserver(flecs::entity e, const Nova::Component::Transform&, const Nova::Component::PointLight&)
 {
-    static auto cam = editorCamera.getCameraProperties();
+    lightManager.markDirty(e);
+}
+
+void Nova::PointLightRemoveObserver(flecs::entity e, const Nova::Component::PointLight&)
+{
+    lightManager.removePointLight(e);
+}
+
+void Nova::StaticCasterObserver(flecs::entity)
+{
+    shadowMaps.markStaticDirty();
+}
+
+//Builds this frame's camera data on the CPU
+static void updateFrameConstants()
+{
+    static auto cam = Nova::editorCamera.getCameraProperties();
 
     //Window size must be accounted for as well due to resize
     Nova::Int windowWidth = 0, windowHeight = 0;
-    glfwGetFramebufferSize(window, &windowWidth, &windowHeight);
+    glfwGetFramebufferSize(Nova::window, &windowWidth, &windowHeight);
+
+    //A minimized window has no area, keep the previous frame's camera
+    if (windowWidth == 0 || windowHeight == 0)
+    {
+        return;
+    }
 
-    //This rotation calculation is needed once per render system call 
-    //Translation MUST ALSO BE APPLIED to work properly
     //TODO: Fix roll rotation on camera
     //Transform to view space
-    Nova::Matrix4 view = editorCamera.viewMatrix();
+    Nova::frameConstants.view = Nova::editorCamera.viewMatrix();
 
     //Project into clip space
-    Nova::Matrix4 proj = Nova::makePerspective(
+    Nova::frameConstants.proj = Nova::makePerspective(
         static_cast<Nova::Float>(windowWidth) / static_cast<Nova::Float>(windowHeight),
         cam.fov * Nova::CONST::DEG_TO_RAD, cam.zNear, cam.zFar); //Do not forget about integer division
 
-    //Loop setup
-    //Activate program and send matrices to shaders
-    glUseProgram(activeProgram);
+    Nova::frameConstants.viewProj = Nova::frameConstants.proj * Nova::frameConstants.view;
+    Nova::frameConstants.viewPos << Nova::editorCamera.getPosition(), 1.0f;
+    Nova::frameConstants.viewport << 0.0f, 0.0f, static_cast<Nova::Float>(windowWidth), static_cast<Nova::Float>(windowHeight);
+
+    Nova::Vector2 sliceParams = Nova::LightClusters::depthSliceParams(cam.zNear, cam.zFar);
+    Nova::frameConstants.clusterParams << cam.zNear, cam.zFar, sliceParams;
+}
+
+//Every program reads the camera from this frame's region of the stream
+static void uploadFrameConstants()
+{
+    Nova::UInt offset;
+    void* dst = Nova::frameConstantsStream.allocate(sizeof(Nova::FrameConstants), offset);
+    std::memcpy(dst, &Nova::frameConstants, sizeof(Nova::FrameConstants));
+
+    Nova::glState.bindBufferRange(GL_UNIFORM_BUFFER, Nova::CONST::FRAME_CONSTANTS_BINDING,
+        Nova::frameConstantsStream.getBuffer(), offset, sizeof(Nova::FrameConstants));
+}
+
+void Nova::FrameConstantsSystem(flecs::iter&)
+{
+    updateFrameConstants();
+
+    //The region from older frames will be overwritten, so upload even if nothing changed
+    uploadFrameConstants();
+}
+
+void Nova::FrustumCullSystem(flecs::iter& it)
+{
+    //The culling functions read both components as plain contiguous arrays
+    static_assert(sizeof(Nova::Component::WorldBounds) == sizeof(Nova::Vector4), "WorldBounds must be a bare sphere");
+    static_assert(sizeof(Nova::Component::Visibility) == sizeof(bool), "Visibility must be a bare bool");
+
+    Nova::Frustum frustum = Nova::extractFrustum(frameConstants.viewProj);
+
+    while (it.next())
+    {
+        auto bounds = it.field<const Nova::Component::WorldBounds>(0);
+        auto visibility = it.field<Nova::Component::Visibility>(1);
+
+        Nova::UInt count = it.count();
+        Nova::UInt visible = Nova::cullSpheres(frustum, &bounds[0].sphere, count, &visibility[0].visible);
+
+        frameStats.objectsDrawn += visible;
+        frameStats.objectsCulled += count - visible;
+    }
+}
+
+void Nova::LightUploadSystem(flecs::iter&)
+{
+    //Every light change this frame has been marked by the observers, send them in one go
+    lightManager.uploadLights();
+}
+
+void Nova::LightClusterSystem(flecs::iter&)
+{
+    static Nova::LightClusters clusters;
+
+    //Only clustered shading reads the clusters
+    if (lightingMode != Nova::LightingMode::CLUSTERED)
+    {
+        return;
+    }
+
+    const auto& bounds = lightManager.getLightBounds();
+    Nova::Float zNear = frameConstants.clusterParams.x();
+    Nova::Float zFar = frameConstants.clusterParams.y();
+
+    auto start = std::chrono::steady_clock::now();
+    clusters.build(frameConstants.view, frameConstants.proj, zNear, zFar, bounds.data(), bounds.size(), jobSystem);
+    std::chrono::duration<Nova::Float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    const auto& grid = clusters.getClusters();
+    const auto& indices = clusters.getLightIndices();
+
+    frameStats.clusterBuildTime = elapsed.count();
+    frameStats.clusterLightRefs = indices.size();
+
+    //Both lists share one allocation, a second one could grow the stream and drop the first binding
+    //An empty range cannot be bound, so the index list always has room for one entry
+    Nova::UInt alignment = clusterStream.getAlignment();
+    Nova::UInt gridSize = sizeof(Nova::ClusterRange) * grid.size();
+    Nova::UInt indexOffset = (gridSize + alignment - 1) / alignment * alignment;
+    Nova::UInt indexSize = sizeof(Nova::UInt) * std::max<Nova::UInt>(indices.size(), 1);
+
+    Nova::UInt offset;
+    Nova::UByte* dst = static_cast<Nova::UByte*>(clusterStream.allocate(indexOffset + indexSize, offset));
+    std::memcpy(dst, grid.data(), gridSize);
+    std::memcpy(dst + indexOffset, indices.data(), sizeof(Nova::UInt) * indices.size());
+
+    glState.bindBufferRange(GL_SHADER_STORAGE_BUFFER, Nova::CONST::CLUSTER_GRID_BINDING, clusterStream.getBuffer(), offset, gridSize);
+    glState.bindBufferRange(GL_SHADER_STORAGE_BUFFER, Nova::CONST::CLUSTER_INDEX_BINDING, clusterStream.getBuffer(), offset + indexOffset, indexSize);
+}
+
+void Nova::DirectionalShadowSystem(flecs::iter& it)
+{
+    static Nova::Array<Nova::ShadowCaster> casters;
+    static Nova::Array<Nova::Vector4> spheres;
 
-    Nova::UInt modelLoc = glGetUniformLocation(activeProgram, "model");
-    Nova::UInt viewLoc = glGetUniformLocation(activeProgram, "view");
-    Nova::UInt projLoc = glGetUniformLocation(activeProgram, "proj");
+    //Only the first directional light is shaded, it keeps w at 0 when there is none
+    Nova::ShadowData data = shadowMaps.getData();
+    data.direction.w() = 0.0f;
 
-    Nova::UInt viewPosLoc = glGetUniformLocation(activeProgram, "viewPos");
+    const Nova::Component::DirectionalLight* sun = nullptr;
+    it.world().each([&sun](flecs::entity, const Nova::Component::DirectionalLight& light)
+    {
+        if (sun == nullptr && light.direction.squaredNorm() > 0.0f)
+        {
+            sun = &light;
+        }
+    });
+
+    if (sun != nullptr)
+    {
+        static auto cam = Nova::editorCamera.getCameraProperties();
+        shadowMaps.update(frameConstants.view, frameConstants.proj, cam.zNear, cam.zFar, sun->direction);
+
+        casters.clear();
+        spheres.clear();
+        while (it.next())
+        {
+            auto transforms = it.field<const Nova::Component::WorldTransform>(0);
+            auto meshes = it.field<const Nova::Component::Mesh>(1);
+            auto bounds = it.field<const Nova::Component::WorldBounds>(2);
+            bool isStatic = it.table().has<Nova::Component::Static>();
+
+            for (auto i : it)
+            {
+                casters.push_back({ &transforms[i].model, &meshes[i].meshInfo, isStatic });
+                spheres.push_back(bounds[i].sphere);
+            }
+        }
+
+        shadowMaps.render(casters, spheres);
+
+        data = shadowMaps.getData();
+        data.ambient << sun->base.ambient, 0.0f;
+        data.diffuse << sun->base.diffuse, 0.0f;
+        data.specular << sun->base.specular, 0.0f;
+    }
+    else
+    {
+        it.fini();
+    }
 
-    glUniformMatrix4fv(viewLoc, 1, GL_FALSE, view.data());
-    glUniformMatrix4fv(projLoc, 1, GL_FALSE, proj.data());
+    //Lit programs always read the block, so it is uploaded even without a light
+    Nova::UInt offset;
+    std::memcpy(shadowStream.allocate(sizeof(Nova::ShadowData), offset), &data, sizeof(Nova::ShadowData));
+    glState.bindBufferRange(GL_UNIFORM_BUFFER, Nova::CONST::SHADOW_DATA_BINDING, shadowStream.getBuffer(), offset, sizeof(Nova::ShadowData));
+    glState.bindTexture(Nova::CONST::SHADOW_MAP_UNIT, shadowMaps.getTexture());
+}
 
-    glUniform3fv(viewPosLoc, 1, editorCamera.getPosition().data());
+void Nova::ObjectRenderSystem(flecs::iter& it)
+{
+    //Storage is kept between frames so it is reused
+    static Nova::RenderQueue queue;
+    static Nova::Array<DrawData> draws;
+    static Nova::Array<DrawGroup> groups;
+    static Nova::Array<Nova::DrawElementsIndirectCommand> commands;
+    static Nova::Array<Nova::InstanceData> instances;
+    static Nova::Array<Nova::Vector4> drawBounds;
+    static Nova::Array<Nova::ObjectLights> drawLights;
+    static Nova::Array<Nova::ObjectLights> objectLights;
+
+    queue.clear();
+    draws.clear();
+    drawBounds.clear();
+
+    //Deferred mode draws the same objects into the G-buffer and lights them afterwards
+    bool deferred = lightingMode == Nova::LightingMode::DEFERRED;
+    if (deferred)
+    {
+        deferredRenderer.beginGeometryPass();
+    }
 
+    //Overdraw stacks onto black so the brightness is only the fragment count
+    bool overdraw = lightingMode == Nova::LightingMode::OVERDRAW;
+    if (overdraw)
+    {
+        const Nova::Float black[] = { 0.0f, 0.0f, 0.0f, 1.0f };
+        glClearNamedFramebufferfv(0, GL_COLOR, 0, black);
+    }
+
+    //Gather every visible object
     while (it.next())
     {
-        auto transforms = it.field<const Nova::Component::Transform>(0);
+        auto transforms = it.field<const Nova::Component::WorldTransform>(0);
         auto meshes = it.field<const Nova::Component::Mesh>(1);
+        auto visibility = it.field<const Nova::Component::Visibility>(2);
+        auto bounds = it.field<const Nova::Component::WorldBounds>(3);
 
-        //Iterate through each object
+        //Iterate through each visible object
         for (auto i : it)
         {
-            //Modify transform properties (locally)
-            Nova::Component::Transform transform = transforms[i];
-            Nova::Component::Mesh mesh = meshes[i];
+            if (!visibility[i].visible)
+            {
+                continue;
+            }
+
+            draws.push_back({ &transforms[i], &meshes[i], nullptr, &bounds[i], nullptr, 0 });
+            drawBounds.push_back(bounds[i].sphere);
+        }
+    }
+
+    //Forward shading loops over a few lights per object, chosen before sorting so each object can use the variant unrolled for its count
+    bool selectLights = lightingMode == Nova::LightingMode::FORWARD;
+    if (selectLights)
+    {
+        selectObjectLights(drawBounds, drawLights);
+    }
+
+    //Queue every object, the key groups them by program, textures and mesh
+    for (Nova::UInt d = 0; d < draws.size(); ++d)
+    {
+        DrawData& draw = draws[d];
+        const Nova::Component::Mesh& mesh = *draw.mesh;
+
+        draw.shader = &objectShader(mesh, selectLights ? drawLights[d].count : 0);
+
+        //A variant still building falls back to the base program, which binds the texture set
+        if (draw.shader->getInfo().features & Nova::ShaderFeature::TEXTURE_ARRAY)
+        {
+            draw.textureArray = mesh.textures[0]->array;
+        }
+
+        Nova::UInt texture = draw.textureArray != 0 ? draw.textureArray : textureKey(mesh);
+        queue.push(queue.makeKey(draw.shader->getProgram(), mesh.meshInfo.firstIndex, texture, viewDepth(draw.transform->model)), d);
+    }
+
+    frameStats.stateChangesSaved += queue.sort();
+
+    //Each run of the same mesh becomes one instanced command, each run of the same program and textures one multi-draw
+    const auto& items = queue.getItems();
+    groups.clear();
+    commands.clear();
+    instances.clear();
+    objectLights.clear();
+
+    for (Nova::UInt i = 0; i < items.size();)
+    {
+        const DrawData& draw = draws[items[i].index];
+        const Nova::Component::Mesh& mesh = *draw.mesh;
+
+        Nova::UInt end = i + 1;
+        while (end < items.size() && sameMesh(mesh.meshInfo, draws[items[end].index].mesh->meshInfo)
+            && sameTextures(draw, draws[items[end].index]) && draw.shader == draws[items[end].index].shader)
+        {
+            ++end;
+        }
+
+        if (groups.empty() || groups.back().shader != draw.shader || groups.back().textureArray != draw.textureArray
+            || (draw.textureArray == 0 && *groups.back().textures != mesh.textures))
+        {
+            groups.push_back({ static_cast<Nova::UInt>(commands.size()), 0, &mesh.textures, draw.textureArray, draw.shader });
+        }
+
+        commands.push_back({ mesh.meshInfo.indexCount, end - i, mesh.meshInfo.firstIndex,
+            static_cast<Nova::Int>(mesh.meshInfo.baseVertex), static_cast<Nova::UInt>(instances.size()) });
+        ++groups.back().commandCount;
+
+        for (Nova::UInt j = i; j < end; ++j)
+        {
+            const DrawData& instanceDraw = draws[items[j].index];
+            const Nova::Component::WorldTransform& transform = *instanceDraw.transform;
+
+            Nova::InstanceData& instance = instances.emplace_back();
+            instance.model = transform.model;
+            instance.normal << transform.normal, Nova::Vector3::Zero().transpose();
+
+            //Instances on one page may each use a different layer of it
+            if (instanceDraw.textureArray != 0)
+            {
+                instance.normal(3, 0) = static_cast<Nova::Float>(instanceDraw.mesh->textures[0]->layer);
+            }
+
+            //Light lists follow the instances, so the shader finds them by the same index
+            if (selectLights)
+            {
+                objectLights.push_back(drawLights[items[j].index]);
+            }
+        }
+
+        i = end;
+    }
+
+    frameStats.objectDrawGroups = groups.size();
+
+    if (!commands.empty())
+    {
+        //Instances are fetched by gl_BaseInstance + gl_InstanceID in the vertex shader
+        //Their light lists share the allocation, a second one could grow the stream and drop the first binding
+        Nova::UInt alignment = instanceStream.getAlignment();
+        Nova::UInt instanceSize = sizeof(Nova::InstanceData) * instances.size();
+        Nova::UInt lightsOffset = (instanceSize + alignment - 1) / alignment * alignment;
+        Nova::UInt lightsSize = selectLights ? sizeof(Nova::ObjectLights) * objectLights.size() : 0;
+
+        Nova::UInt instanceOffset;
+        Nova::UByte* dst = static_cast<Nova::UByte*>(instanceStream.allocate(lightsOffset + lightsSize, instanceOffset));
+        std::memcpy(dst, instances.data(), instanceSize);
+        glState.bindBufferRange(GL_SHADER_STORAGE_BUFFER, Nova::CONST::INSTANCE_DATA_BINDING, instanceStream.getBuffer(), instanceOffset, instanceSize);
+
+        if (selectLights)
+        {
+            std::memcpy(dst + lightsOffset, objectLights.data(), lightsSize);
+            glState.bindBufferRange(GL_SHADER_STORAGE_BUFFER, Nova::CONST::OBJECT_LIGHTS_BINDING, instanceStream.getBuffer(), instanceOffset + lightsOffset, lightsSize);
+        }
+
+        Nova::UInt commandSize = sizeof(Nova::DrawElementsIndirectCommand) * commands.size();
+        Nova::UInt commandOffset;
+        std::memcpy(indirectStream.allocate(commandSize, commandOffset), commands.data(), commandSize);
+        glState.bindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectStream.getBuffer());
+
+        //Every mesh lives in the pool, so one VAO serves all of them
+        glState.bindVertexArray(meshPool.getVAO());
+
+        //Depth only needs positions, so every command goes out in one call without textures
+        if (depthPrePass)
+        {
+            glState.useProgram(depthPrePassShader.getProgram());
+            glState.setColorMask(false);
+
+            depthPrePassTimer.begin();
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)(std::size_t)commandOffset, commands.size(), 0);
+            depthPrePassTimer.end();
+
+            //Only the surface that won the pre-pass is shaded, and its depth is already written
+            glState.setColorMask(true);
+            glState.setDepthFunc(GL_EQUAL);
+            glState.setDepthMask(false);
+        }
+
+        if (overdraw)
+        {
+            glState.setBlend(true);
+            glState.setBlendFunc(GL_ONE, GL_ONE);
+        }
 
-            //Perform world space transformations
-            Nova::Affine3 model = Nova::Affine3::Identity();
-            model.translate(transform.position);
-            model.rotate(Nova::rotateFromEuler(transform.rotation));
-            model.scale(transform.scale);
+        objectPassTimer.begin();
+        shadedSamplesQuery.begin();
 
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, model.data());
+        //Groups are sorted by program, so each variant is bound once
+        for (const auto& group : groups)
+        {
+            glState.useProgram(group.shader->getProgram());
 
-            //Attach textures
-            for (int j = 0; j < mesh.textures.size(); ++j)
+            if (group.textureArray != 0)
+            {
+                glState.bindTexture(Nova::CONST::TEXTURE_ARRAY_UNIT, group.textureArray);
+            }
+            else
             {
-                glActiveTexture(GL_TEXTURE0 + j);
-                glBindTexture(GL_TEXTURE_2D, mesh.textures[j]->texture);
+                bindTextures(*group.textures);
             }
 
-            //Render the mesh
-            glBindVertexArray(mesh.meshInfo.VAO);
-            glDrawElements(GL_TRIANGLES, mesh.meshInfo.indexCount, GL_UNSIGNED_INT, 0);
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+                (void*)(commandOffset + sizeof(Nova::DrawElementsIndirectCommand) * group.firstCommand), group.commandCount, 0);
         }
+
+        shadedSamplesQuery.end();
+        objectPassTimer.end();
+
+        //Put back the state the later passes expect
+        glState.setDepthFunc(GL_LESS);
+        glState.setDepthMask(true);
+        glState.setBlend(false);
+    }
+
+    if (deferred)
+    {
+        deferredRenderer.lightingPass();
     }
 
+    frameStats.objectPassTime = objectPassTimer.getTime();
+    frameStats.depthPrePassTime = depthPrePass ? depthPrePassTimer.getTime() : 0.0f;
+    frameStats.samplesShaded = shadedSamplesQuery.getResult();
+    frameStats.lightingPassTime = lightingPassTimer.getTime();
+
     if (!activeObj.is_valid())
     {
         return;
@@ -84,99 +589,66 @@ void Nova::ObjectRenderSystem(flecs::iter& it)
     //Active object gets another pass to run the geometry shader
     if (activeObj.has<Nova::Component::Mesh>())
     {
-        //Get the active object and do the same transform stuff
-        auto activeTransform = activeObj.get_ref<Nova::Component::Transform>();
-        Nova::Affine3 model = Nova::Affine3::Identity();
-        model.translate(activeTransform->position);
-        model.rotate(Nova::rotateFromEuler(activeTransform->rotation));
-        model.scale(activeTransform->scale);
+        //The active object is already in a batch, reuse its cached model matrix
+        auto activeTransform = activeObj.get<Nova::Component::WorldTransform>();
 
         //Send to active object shader
-        Nova::ShaderProgram program = activeObjShader.getProgram();
-        glUseProgram(program);
-
-        //TODO: Refactor
-        Nova::UInt modelLoc = glGetUniformLocation(program, "model");
-        Nova::UInt viewLoc = glGetUniformLocation(program, "view");
-        Nova::UInt projLoc = glGetUniformLocation(program, "proj");
+        glState.useProgram(activeObjShader.getProgram());
 
-        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, model.data());
-        glUniformMatrix4fv(viewLoc, 1, GL_FALSE, view.data());
-        glUniformMatrix4fv(projLoc, 1, GL_FALSE, proj.data());
+        activeObjShader.setMat4(MODEL_HASH, activeTransform->model);
 
         //Render
         auto activeMesh = activeObj.get_ref<Nova::Component::Mesh>();
-        glBindVertexArray(activeMesh->meshInfo.VAO);
-        glDrawElements(GL_TRIANGLES, activeMesh->meshInfo.indexCount, GL_UNSIGNED_INT, 0);
-    }
-
-    //Allow light values to change if the object is active
-    if (activeObj.has<Nova::Component::PointLight>())
-    {
-        lightManager.loadPointLight(activeObj);
+        drawMesh(activeMesh->meshInfo);
     }
 }
 
 void Nova::PointLightRenderSystem(flecs::iter & it)
 {
-    static auto cam = editorCamera.getCameraProperties();
-
-    //Window size must be accounted for as well due to resize
-    int windowWidth = 0, windowHeight = 0;
-    glfwGetFramebufferSize(window, &windowWidth, &windowHeight);
-
-    //This rotation calculation is needed once per render system call 
-    //Translation MUST ALSO BE APPLIED to work properly
-    //TODO: Fix roll rotation on camera
-    //Transform to view space
-    Nova::Matrix4 view = editorCamera.viewMatrix();
-
-    //Project into clip space
-    Nova::Matrix4 proj = Nova::makePerspective(
-        static_cast<Nova::Float>(windowWidth) / static_cast<Nova::Float>(windowHeight),
-        cam.fov * Nova::CONST::DEG_TO_RAD, cam.zNear, cam.zFar); //Do not forget about integer division
-
-    //Loop setup
-    //Activate program and send matrices to shaders
-    Nova::ShaderProgram program = lightSourceShader.getProgram();
-    glUseProgram(program);
-
-    Nova::UInt modelLoc = glGetUniformLocation(program, "model");
-    Nova::UInt viewLoc = glGetUniformLocation(program, "view");
-    Nova::UInt projLoc = glGetUniformLocation(program, "proj");
+    static Nova::RenderQueue queue;
+    static Nova::Array<DrawData> draws;
 
-    Nova::UInt lightColorLoc = glGetUniformLocation(program, "lightColor");
-
-    glUniformMatrix4fv(viewLoc, 1, GL_FALSE, view.data());
-    glUniformMatrix4fv(projLoc, 1, GL_FALSE, proj.data());
+    queue.clear();
+    draws.clear();
 
+    Nova::UInt program = lightSourceShader.getProgram();
     while (it.next())
     {
-        auto transforms = it.field<const Nova::Component::Transform>(0);
+        auto transforms = it.field<const Nova::Component::WorldTransform>(0);
         auto meshes = it.field<const Nova::Component::Mesh>(1);
         auto lights = it.field<const Nova::Component::PointLight>(2);
+        auto visibility = it.field<const Nova::Component::Visibility>(3);
 
-        //Iterate through each object
+        //Iterate through each visible object
         for (auto i : it)
         {
-            //Modify transform properties (locally)
-            Nova::Component::Transform transform = transforms[i];
-            Nova::Component::Mesh mesh = meshes[i];
-            Nova::Component::PointLight pointLight = lights[i];
-
-            //Perform world space transformations
-            Nova::Affine3 model = Nova::Affine3::Identity();
-            model.translate(transform.position);
-            model.rotate(Nova::rotateFromEuler(transform.rotation));
-            model.scale(transform.scale);
-
-            //Set model matrix and light color
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, model.data());
-            glUniform3fv(lightColorLoc, 1, pointLight.base.diffuse.data());
-
-            //Render the mesh
-            glBindVertexArray(mesh.meshInfo.VAO);
-            glDrawElements(GL_TRIANGLES, mesh.meshInfo.indexCount, GL_UNSIGNED_INT, 0);
+            if (!visibility[i].visible)
+            {
+                continue;
+            }
+
+            const Nova::Component::Mesh& mesh = meshes[i];
+
+            queue.push(queue.makeKey(program, mesh.meshInfo.firstIndex, 0, viewDepth(transforms[i].model)), draws.size());
+            draws.push_back({ &transforms[i], &mesh, &lights[i], nullptr });
         }
     }
+
+    frameStats.stateChangesSaved += queue.sort();
+
+    //Loop setup
+    //Activate program and send matrices to shaders
+    glState.useProgram(program);
+
+    for (const auto& item : queue.getItems())
+    {
+        const DrawData& draw = draws[item.index];
+
+        //Set model matrix and light color
+        lightSourceShader.setMat4(MODEL_HASH, draw.transform->model);
+        lightSourceShader.setVec3(LIGHT_COLOR_HASH, draw.light->base.diffuse);
+
+        //Render the mesh
+        drawMesh(draw.mesh->meshInfo);
+    }
 }
\ No newline at end of file
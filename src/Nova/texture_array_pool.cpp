@@ -0,0 +1,154 @@
+#include <Nova/texture_array_pool.hpp>
+
+#include <algorithm>
+#include <glad/glad.h>
+
+#include <Nova/const.hpp>
+#include <Nova/engine.hpp>
+
+static Nova::UInt createPageTexture(Nova::Int levels, Nova::UInt internalFormat, Nova::Int width, Nova::Int height, Nova::UInt layers)
+{
+	Nova::UInt texture;
+	glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &texture);
+	glTextureStorage3D(texture, levels, internalFormat, width, height, layers);
+
+	//Same sampling as the single textures from loadTexture
+	glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	return texture;
+}
+
+Nova::TextureArrayPool::TextureArrayPool() {}
+
+bool Nova::TextureArrayPool::add(Nova::TextureInfo& texture)
+{
+	if (texture.texture == 0 || texture.array != 0)
+	{
+		return false;
+	}
+
+	GLint width, height, internalFormat;
+	glGetTextureLevelParameteriv(texture.texture, 0, GL_TEXTURE_WIDTH, &width);
+	glGetTextureLevelParameteriv(texture.texture, 0, GL_TEXTURE_HEIGHT, &height);
+	glGetTextureLevelParameteriv(texture.texture, 0, GL_TEXTURE_INTERNAL_FORMAT, &internalFormat);
+
+	if (width <= 0 || height <= 0)
+	{
+		return false;
+	}
+
+	Page* page = nullptr;
+	for (auto& candidate : pages)
+	{
+		if (candidate.width == width && candidate.height == height && candidate.internalFormat == static_cast<Nova::UInt>(internalFormat)
+			&& candidate.layers < Nova::CONST::TEXTURE_ARRAY_LAYERS)
+		{
+			page = &candidate;
+			break;
+		}
+	}
+
+	if (page == nullptr)
+	{
+		//Every level down to 1x1, like glGenerateMipmap gives a single texture
+		Nova::Int levels = 1;
+		for (Nova::Int size = std::max(width, height); size > 1; size /= 2)
+		{
+			++levels;
+		}
+
+		Page newPage = { 0, width, height, static_cast<Nova::UInt>(internalFormat), levels, 0, 1 };
+		newPage.texture = createPageTexture(levels, newPage.internalFormat, width, height, newPage.capacity);
+
+		pages.push_back(newPage);
+		page = &pages.back();
+	}
+	else if (page->layers == page->capacity)
+	{
+		grow(*page);
+	}
+
+	//The 2D texture already has its mips, so each level is copied instead of regenerating the page
+	for (Nova::Int level = 0; level < page->levels; ++level)
+	{
+		Nova::Int levelWidth = std::max(width >> level, 1);
+		Nova::Int levelHeight = std::max(height >> level, 1);
+
+		glCopyImageSubData(texture.texture, GL_TEXTURE_2D, level, 0, 0, 0,
+			page->texture, GL_TEXTURE_2D_ARRAY, level, 0, 0, page->layers,
+			levelWidth, levelHeight, 1);
+	}
+
+	texture.array = page->texture;
+	texture.layer = page->layers++;
+	page->textures.push_back(&texture);
+
+	return true;
+}
+
+void Nova::TextureArrayPool::addAll(const Nova::Array<Nova::TextureInfo*>& textureSet)
+{
+	for (auto texture : textureSet)
+	{
+		add(*texture);
+	}
+}
+
+void Nova::TextureArrayPool::grow(Page& page)
+{
+	Nova::UInt capacity = std::min(page.capacity * 2, Nova::CONST::TEXTURE_ARRAY_LAYERS);
+	Nova::UInt texture = createPageTexture(page.levels, page.internalFormat, page.width, page.height, capacity);
+
+	for (Nova::Int level = 0; level < page.levels; ++level)
+	{
+		Nova::Int levelWidth = std::max(page.width >> level, 1);
+		Nova::Int levelHeight = std::max(page.height >> level, 1);
+
+		glCopyImageSubData(page.texture, GL_TEXTURE_2D_ARRAY, level, 0, 0, 0,
+			texture, GL_TEXTURE_2D_ARRAY, level, 0, 0, 0,
+			levelWidth, levelHeight, page.layers);
+	}
+
+	//The new page may reuse the old name, so the shadowed bindings can no longer be trusted
+	glDeleteTextures(1, &page.texture);
+	Nova::glState.invalidate();
+
+	page.texture = texture;
+	page.capacity = capacity;
+
+	for (auto packed : page.textures)
+	{
+		packed->array = texture;
+	}
+}
+
+void Nova::TextureArrayPool::clear()
+{
+	for (const auto& page : pages)
+	{
+		glDeleteTextures(1, &page.texture);
+	}
+
+	pages.clear();
+
+	Nova::glState.invalidate();
+}
+
+Nova::UInt Nova::TextureArrayPool::getPageCount() const
+{
+	return static_cast<Nova::UInt>(pages.size());
+}
+
+Nova::UInt Nova::TextureArrayPool::getLayerCount() const
+{
+	Nova::UInt layers = 0;
+	for (const auto& page : pages)
+	{
+		layers += page.layers;
+	}
+
+	return layers;
+}
\ No newline at end of file
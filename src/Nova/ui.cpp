@@ -75,16 +75,77 @@ void Nova::EditorUI::MainMenu(GLFWwindow* window, const flecs::world& ecs, Nova:
         {
             if (ImGui::MenuItem("Recompile Shaders"))
             {
+                //Shaders keep their identity across recompiles and lights live in a buffer, so nothing needs resending
+                //The new programs are swapped in once they link, rendering carries on meanwhile
                 Nova::shaderManager.recompileShaders();
-                Nova::lightManager.clearPrograms();
+            }
+
+            //Lights static meshes from the current point lights, the probes are saved with the scene
+            if (ImGui::MenuItem("Bake Probes"))
+            {
+                Nova::bakeProbes();
+            }
+
+            if (ImGui::BeginMenu("Overdraw Benchmark"))
+            {
+                //Layers of cubes covering each other, compare shaded samples with the depth pre-pass on and off
+                if (ImGui::MenuItem("Spawn Cube Field"))
+                {
+                    for (Nova::Int z = 0; z < Nova::CONST::OVERDRAW_BENCHMARK_DEPTH; ++z)
+                    {
+                        for (Nova::Int x = 0; x < Nova::CONST::BENCHMARK_GRID_SIZE; ++x)
+                        {
+                            for (Nova::Int y = 0; y < Nova::CONST::BENCHMARK_GRID_SIZE; ++y)
+                            {
+                                Nova::Component::Transform transform = Nova::Component::DEFAULT_TRANSFORM;
+                                transform.position = Nova::Vector3(x * 1.2f, y * 1.2f, -10.0f - z * 1.5f);
+                                transform.rotation = Nova::Vector3(15.0f * z, 30.0f * x, 45.0f * y);
+
+                                Nova::Int index = (z * Nova::CONST::BENCHMARK_GRID_SIZE + x) * Nova::CONST::BENCHMARK_GRID_SIZE + y;
+
+                                auto cube = Nova::createCube();
+                                cube.set_doc_name(("Field Cube " + std::to_string(index)).c_str());
+                                cube.set<Nova::Component::Transform>(transform);
+                                cube.add<Nova::Component::Static>();
+
+                                objs.push_back(cube);
+                            }
+                        }
+                    }
+                }
+
+                ImGui::EndMenu();
+            }
+
+            if (ImGui::BeginMenu("Vertex Benchmark"))
+            {
+                //A grid of dense spheres makes the object pass vertex bound, compare its GPU time in Statistics
+                if (ImGui::MenuItem("Spawn Dense Spheres"))
+                {
+                    for (Nova::Int x = 0; x < Nova::CONST::BENCHMARK_GRID_SIZE; ++x)
+                    {
+                        for (Nova::Int y = 0; y < Nova::CONST::BENCHMARK_GRID_SIZE; ++y)
+                        {
+                            Nova::Component::Transform transform = Nova::Component::DEFAULT_TRANSFORM;
+                            transform.position = Nova::Vector3(x * 1.5f, y * 1.5f, -20.0f);
+
+                            auto sphere = Nova::createSphere();
+                            sphere.set_doc_name(("Sphere " + std::to_string(x * Nova::CONST::BENCHMARK_GRID_SIZE + y)).c_str());
+                            sphere.set<Nova::Component::Transform>(transform);
+
+                            objs.push_back(sphere);
+                        }
+                    }
+                }
 
-                for (auto program : Nova::shaderManager.getShaderPrograms())
+                bool inverseInShader = Nova::activeShader == &Nova::normalBenchShader;
+                if (ImGui::MenuItem("Invert Normal Matrix Per Vertex", NULL, &inverseInShader))
                 {
-                    lightManager.addProgram(program);
+                    Nova::lightingMode = Nova::LightingMode::FORWARD;
+                    Nova::activeShader = inverseInShader ? &Nova::normalBenchShader : &Nova::forwardShader;
                 }
 
-                Nova::lightManager.loadPointLights();
-                Nova::activeProgram = Nova::forwardShader.getProgram();
+                ImGui::EndMenu();
             }
 
             ImGui::EndMenu();
@@ -94,19 +155,63 @@ void Nova::EditorUI::MainMenu(GLFWwindow* window, const flecs::world& ecs, Nova:
         {
             if (ImGui::BeginMenu("Lighting Mode"))
             {
-                if (ImGui::MenuItem("Default"))
+                if (ImGui::MenuItem("Default", NULL, Nova::lightingMode == Nova::LightingMode::FORWARD))
+                {
+                    Nova::lightingMode = Nova::LightingMode::FORWARD;
+                    Nova::activeShader = &Nova::forwardShader;
+                }
+
+                if (ImGui::MenuItem("Clustered", NULL, Nova::lightingMode == Nova::LightingMode::CLUSTERED))
+                {
+                    Nova::lightingMode = Nova::LightingMode::CLUSTERED;
+                    Nova::activeShader = &Nova::clusteredShader;
+                }
+
+                if (ImGui::MenuItem("Unlit", NULL, Nova::lightingMode == Nova::LightingMode::UNLIT))
                 {
-                    Nova::activeProgram = Nova::forwardShader.getProgram();
+                    Nova::lightingMode = Nova::LightingMode::UNLIT;
+                    Nova::activeShader = &Nova::unlitShader;
                 }
 
-                if (ImGui::MenuItem("Unlit"))
+                if (ImGui::MenuItem("Deferred", NULL, Nova::lightingMode == Nova::LightingMode::DEFERRED))
                 {
-                    Nova::activeProgram = Nova::unlitShader.getProgram();
+                    Nova::lightingMode = Nova::LightingMode::DEFERRED;
+                    Nova::activeShader = &Nova::gbufferShader;
+                }
+
+                //Brighter pixels were shaded more times, compare with the depth pre-pass on and off
+                if (ImGui::MenuItem("Overdraw", NULL, Nova::lightingMode == Nova::LightingMode::OVERDRAW))
+                {
+                    Nova::lightingMode = Nova::LightingMode::OVERDRAW;
+                    Nova::activeShader = &Nova::overdrawShader;
+                }
+
+                //Point lights come from the probes made by Tools > Bake Probes
+                if (ImGui::MenuItem("Baked", NULL, Nova::lightingMode == Nova::LightingMode::BAKED))
+                {
+                    Nova::lightingMode = Nova::LightingMode::BAKED;
+                    Nova::activeShader = &Nova::forwardShader;
                 }
 
                 ImGui::EndMenu();
             }
 
+            ImGui::MenuItem("Depth Pre-Pass", NULL, &Nova::depthPrePass);
+
+            //Objects differing only by texture share a multi-draw, compare the multi-draw count with it off
+            //Textures are only packed while this is on, so the ones loaded before are packed now
+            if (ImGui::MenuItem("Texture Arrays", NULL, &Nova::textureArrays) && Nova::textureArrays)
+            {
+                Nova::textureArrayPool.addAll(Nova::globalTextures);
+            }
+
+            //Lower cutoffs give lights larger radii, so more of them reach each object
+            Nova::Float cutoff = Nova::lightManager.getAttenuationCutoff() * 256.0f;
+            if (ImGui::SliderFloat("Light Cutoff (/256)", &cutoff, 0.25f, 16.0f, "%.2f"))
+            {
+                Nova::lightManager.setAttenuationCutoff(cutoff / 256.0f);
+            }
+
             ImGui::EndMenu();
         }
 
@@ -141,6 +246,15 @@ void Nova::EditorUI::MainMenu(GLFWwindow* window, const flecs::world& ecs, Nova:
                         objs.push_back(pl);
                     }
 
+                    //Only the first directional light is shaded and casts shadows
+                    if (ImGui::MenuItem("Directional"))
+                    {
+                        auto dl = Nova::createDirectionalLight();
+                        dl.set_doc_name("DLight");
+
+                        objs.push_back(dl);
+                    }
+
                     ImGui::EndMenu();
                 }
 
@@ -277,9 +391,33 @@ void Nova::EditorUI::ShowObjectProperties(Nova::Entity& obj)
         
         if(ImGui::CollapsingHeader("Transform"))
         {
-            ImGui::DragFloat3("Position", &(activeTransform->position(0)), 0.05f);
-            ImGui::DragFloat3("Rotation", &(activeTransform->rotation(0)), 1.0f);
-            ImGui::DragFloat3("Scale", &(activeTransform->scale(0)), 0.1f);
+            bool changed = false;
+            changed |= ImGui::DragFloat3("Position", &(activeTransform->position(0)), 0.05f);
+            changed |= ImGui::DragFloat3("Rotation", &(activeTransform->rotation(0)), 1.0f);
+            changed |= ImGui::DragFloat3("Scale", &(activeTransform->scale(0)), 0.1f);
+
+            //Edits through the ref bypass flecs, notify it so the WorldTransform is rebuilt
+            if (changed)
+            {
+                obj.modified<Nova::Component::Transform>();
+            }
+
+            //Static objects keep their shadows cached, objects that move often should not be static
+            if (obj.has<Nova::Component::Mesh>())
+            {
+                bool isStatic = obj.has<Nova::Component::Static>();
+                if (ImGui::Checkbox("Static", &isStatic))
+                {
+                    if (isStatic)
+                    {
+                        obj.add<Nova::Component::Static>();
+                    }
+                    else
+                    {
+                        obj.remove<Nova::Component::Static>();
+                    }
+                }
+            }
         }
 
         if(obj.has<Nova::Component::Camera>() && ImGui::CollapsingHeader("Camera"))
@@ -319,13 +457,36 @@ void Nova::EditorUI::ShowObjectProperties(Nova::Entity& obj)
         {
             auto lightProps = obj.get_ref<Nova::Component::PointLight>();
 
-            ImGui::DragFloat3("Ambient", &(lightProps->base.ambient(0)), 0.005f, 0.0f, 1.0f);
-            ImGui::DragFloat3("Diffuse", &(lightProps->base.diffuse(0)), 0.005f, 0.0f, 1.0f);
-            ImGui::DragFloat3("Specular", &(lightProps->base.specular(0)), 0.005f, 0.0f, 1.0f);
+            bool changed = false;
+            changed |= ImGui::DragFloat3("Ambient", &(lightProps->base.ambient(0)), 0.005f, 0.0f, 1.0f);
+            changed |= ImGui::DragFloat3("Diffuse", &(lightProps->base.diffuse(0)), 0.005f, 0.0f, 1.0f);
+            changed |= ImGui::DragFloat3("Specular", &(lightProps->base.specular(0)), 0.005f, 0.0f, 1.0f);
+
+            changed |= ImGui::DragFloat("Constant", &(lightProps->constant), 1.0f);
+            changed |= ImGui::DragFloat("Linear", &(lightProps->linear), 0.05f);
+            changed |= ImGui::DragFloat("Quadratic", &(lightProps->quadratic), 0.01f);
+
+            //The light manager only uploads lights that flecs reports as changed
+            if (changed)
+            {
+                obj.modified<Nova::Component::PointLight>();
+            }
+        }
+
+        if (obj.has<Nova::Component::DirectionalLight>() && ImGui::CollapsingHeader("Directional Light"))
+        {
+            auto lightProps = obj.get_ref<Nova::Component::DirectionalLight>();
+
+            bool changed = false;
+            changed |= ImGui::DragFloat3("Ambient", &(lightProps->base.ambient(0)), 0.005f, 0.0f, 1.0f);
+            changed |= ImGui::DragFloat3("Diffuse", &(lightProps->base.diffuse(0)), 0.005f, 0.0f, 1.0f);
+            changed |= ImGui::DragFloat3("Specular", &(lightProps->base.specular(0)), 0.005f, 0.0f, 1.0f);
+            changed |= ImGui::DragFloat3("Direction", &(lightProps->direction(0)), 0.01f, -1.0f, 1.0f);
 
-            ImGui::DragFloat("Constant", &(lightProps->constant), 1.0f);
-            ImGui::DragFloat("Linear", &(lightProps->linear), 0.05f);
-            ImGui::DragFloat("Quadratic", &(lightProps->quadratic), 0.01f);
+            if (changed)
+            {
+                obj.modified<Nova::Component::DirectionalLight>();
+            }
         }
     }
 
@@ -385,5 +546,107 @@ void Nova::EditorUI::ShowObjectList(Nova::Array<Nova::Entity>& objs, Nova::Entit
         ImGui::EndListBox();
     }
     
+    ImGui::End();
+}
+
+void Nova::EditorUI::ShowStatistics(const Nova::FrameStats& stats)
+{
+    if (ImGui::Begin("Statistics"))
+    {
+        ImGui::Text("Frame time: %.2f ms", Nova::deltaTime * 1000.0f);
+
+        if (ImGui::CollapsingHeader("Shaders", ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            ImGui::Text("Uniform lookups avoided: %u", stats.uniformLookupsSaved);
+
+            //Every variant splits the object pass into more multi-draws
+            ImGui::Text("Variants compiled: %u", Nova::shaderManager.getVariantCount());
+            ImGui::Text("Object pass multi-draws: %u", stats.objectDrawGroups);
+
+            //Totals since startup, a warm start should load every program from the cache
+            ImGui::Text("Programs cached: %u (%.1f ms)", Nova::programCache.getHits(), Nova::programCache.getLoadTime());
+            ImGui::Text("Programs compiled: %u (%.1f ms)", Nova::programCache.getMisses(), Nova::programCache.getCompileTime());
+
+            //Programs still building keep drawing with their previous version
+            static const char* compileModes[] = { "Synchronous", "Driver parallel", "Worker contexts" };
+            ImGui::Text("Compile mode: %s", compileModes[Nova::shaderManager.getCompileMode()]);
+            ImGui::Text("Programs building: %u", Nova::shaderManager.getBuildingCount());
+
+            //Saving a watched file rebuilds only the programs that read it
+            ImGui::Text("Shader files watched: %u", Nova::shaderManager.getWatchedFileCount());
+            ImGui::Text("Programs hot reloaded: %u", Nova::shaderManager.getReloadCount());
+
+            //Programs sharing a stage read, expand and compile it once
+            ImGui::Text("Shader files read: %u", Nova::shaderSources.getFilesRead());
+            ImGui::Text("Stages expanded: %u (%u reused)", Nova::shaderSources.getExpansions(), Nova::shaderSources.getHits());
+            ImGui::Text("Stage objects shared: %u", Nova::shaderManager.getStageReuseCount());
+        }
+
+        if (ImGui::CollapsingHeader("Render Queue", ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            ImGui::Text("State changes saved by sorting: %u", stats.stateChangesSaved);
+            ImGui::Text("Texture array pages: %u (%u layers)", Nova::textureArrayPool.getPageCount(), Nova::textureArrayPool.getLayerCount());
+        }
+
+        if (ImGui::CollapsingHeader("Culling", ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            ImGui::Text("Objects drawn: %u", stats.objectsDrawn);
+            ImGui::Text("Objects culled: %u", stats.objectsCulled);
+        }
+
+        if (ImGui::CollapsingHeader("GL State", ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            ImGui::Text("Calls issued: %u", stats.glCallsIssued);
+            ImGui::Text("Calls skipped: %u", stats.glCallsSkipped);
+        }
+
+        if (ImGui::CollapsingHeader("GPU Time", ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            //In deferred mode the object pass is the G-buffer pass
+            ImGui::Text("Object pass: %.3f ms", stats.objectPassTime);
+            ImGui::Text("Depth pre-pass: %.3f ms", stats.depthPrePassTime);
+            ImGui::Text("Deferred lighting pass: %.3f ms", stats.lightingPassTime);
+        }
+
+        if (ImGui::CollapsingHeader("Overdraw", ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            //One shaded sample per pixel is the best the object pass can do
+            Nova::Float pixels = std::max(Nova::frameConstants.viewport.z() * Nova::frameConstants.viewport.w(), 1.0f);
+            ImGui::Text("Samples shaded: %llu", static_cast<unsigned long long>(stats.samplesShaded));
+            ImGui::Text("Shaded per pixel: %.2f", static_cast<Nova::Float>(stats.samplesShaded) / pixels);
+        }
+
+        if (ImGui::CollapsingHeader("Lighting", ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            ImGui::Text("Point lights: %u", Nova::lightManager.getPointLightCount());
+            ImGui::Text("Lights uploaded: %u in %u ranges", stats.lightsUploaded, stats.lightUploads);
+            ImGui::Text("Cluster light references: %u", stats.clusterLightRefs);
+            ImGui::Text("Cluster build time: %.3f ms", stats.clusterBuildTime);
+            ImGui::Text("Object lights: %u of %u candidates", stats.objectLightRefs, stats.objectLightCandidates);
+            ImGui::Text("Light selection time: %.3f ms", stats.lightSelectionTime);
+            ImGui::Text("Light grid cells: %u, oversized lights: %u", Nova::lightManager.getLightGrid().getCellCount(), Nova::lightManager.getLightGrid().getOversizedCount());
+        }
+
+        if (ImGui::CollapsingHeader("Shadows", ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            //Skipped cascades kept last frame's map, static refreshes redrew the cached statics
+            ImGui::Text("Cascades rendered: %u", stats.shadowCascadesRendered);
+            ImGui::Text("Cascades skipped: %u", stats.shadowCascadesSkipped);
+            ImGui::Text("Static cache refreshes: %u", stats.shadowStaticRefreshes);
+        }
+
+        if (ImGui::CollapsingHeader("Baked Lighting", ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            ImGui::Text("Probes: %u", Nova::probeGrid.getProbeCount());
+        }
+
+        if (ImGui::CollapsingHeader("Streaming", ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            //Time blocked here is time the CPU ran out of frames ahead of the GPU
+            ImGui::Text("Fence waits: %u", stats.fenceWaits);
+            ImGui::Text("Fence wait time: %.3f ms", stats.fenceWaitTime);
+        }
+    }
+
     ImGui::End();
 }
\ No newline at end of file
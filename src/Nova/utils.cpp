@@ -5,6 +5,10 @@
 #include <iostream>
 #include <stdio.h>
 #include <fstream>
+#include <limits>
+#include <algorithm>
+#include <unordered_map>
+#include <filesystem>
 
 #include <stb_image.h>
 #include <json/json.h>
@@ -12,6 +16,7 @@
 #include <Nova/const.hpp>
 #include <Nova/engine.hpp>
 #include <Nova/objects.hpp>
+#include <Nova/probe_baker.hpp>
 
 Nova::String Nova::readFileToString(Nova::String filename)
 {
@@ -36,6 +41,14 @@ Nova::String Nova::readFileToString(Nova::String filename)
 	return Nova::String("Could not read file.");
 }
 
+Nova::String Nova::normalizePath(const Nova::String& path)
+{
+	std::error_code err;
+	std::filesystem::path normal = std::filesystem::weakly_canonical(std::filesystem::absolute(path, err), err);
+
+	return err ? std::filesystem::path(path).lexically_normal().string() : normal.string();
+}
+
 Nova::TextureInfo* Nova::findTexture(const Nova::String& name, const Nova::Array<Nova::TextureInfo*>& textures)
 {
 	for (auto& texture : textures)
@@ -50,6 +63,27 @@ Nova::TextureInfo* Nova::findTexture(const Nova::String& name, const Nova::Array
 	return NULL;
 }
 
+void Nova::computeMeshBounds(Nova::MeshInfo& mesh, const Nova::VertexData* vertices, Nova::UInt vertexCount)
+{
+	mesh.boundsMin = Nova::Vector3::Constant(std::numeric_limits<Nova::Float>::max());
+	mesh.boundsMax = Nova::Vector3::Constant(std::numeric_limits<Nova::Float>::lowest());
+
+	for (Nova::UInt i = 0; i < vertexCount; ++i)
+	{
+		mesh.boundsMin = mesh.boundsMin.cwiseMin(vertices[i].pos);
+		mesh.boundsMax = mesh.boundsMax.cwiseMax(vertices[i].pos);
+	}
+
+	//Sphere around the box center, radius from the farthest vertex so it stays tight
+	mesh.sphereCenter = (mesh.boundsMin + mesh.boundsMax) * 0.5f;
+	mesh.sphereRadius = 0.0f;
+
+	for (Nova::UInt i = 0; i < vertexCount; ++i)
+	{
+		mesh.sphereRadius = std::max(mesh.sphereRadius, (vertices[i].pos - mesh.sphereCenter).norm());
+	}
+}
+
 Nova::MeshInfo Nova::findMesh(const Nova::String& name, const Nova::Array<MeshInfo>& meshes)
 {
 	for (auto& mesh : meshes)
@@ -65,21 +99,26 @@ Nova::MeshInfo Nova::findMesh(const Nova::String& name, const Nova::Array<MeshIn
 	invalidMesh.indexCount = -1;
 	invalidMesh.name = "INVALID";
 	invalidMesh.VAO = -1;
+	invalidMesh.baseVertex = invalidMesh.vertexCount = invalidMesh.firstIndex = 0;
+	invalidMesh.boundsMin = invalidMesh.boundsMax = invalidMesh.sphereCenter = Nova::Vector3::Zero();
+	invalidMesh.sphereRadius = 0.0f;
 
 	return invalidMesh;
 }
 
 void Nova::deleteMeshes(Nova::Array<Nova::MeshInfo>& meshes)
 {
-	for (auto mesh : meshes)
+	//The pool owns the GL objects, meshes only give back their ranges
+	for (const auto& mesh : meshes)
 	{
-		glDeleteVertexArrays(1, &mesh.VAO);
-		glDeleteBuffers(1, &mesh.VBO);
-		glDeleteBuffers(1, &mesh.VBO);
+		Nova::meshPool.free(mesh);
 	}
 
 	meshes.clear();
 	meshes.shrink_to_fit();
+
+	//Deleted names can be handed out again, so the shadowed bindings are no longer trustworthy
+	Nova::glState.invalidate();
 }
 
 void Nova::processInput(GLFWwindow* window, Nova::Editor::EditorCamera& cam, Nova::Float dt)
@@ -129,7 +168,7 @@ Nova::TextureInfo* Nova::loadTexture(Nova::String name, Nova::String filename, N
 	//Create the texture object
 	GLuint textureObj;
 	glGenTextures(1, &textureObj);
-	glBindTexture(GL_TEXTURE_2D, textureObj);
+	glState.bindTexture(0, textureObj);
 
 	//TODO: Somehow allow user defined texture settings
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -158,7 +197,8 @@ Nova::TextureInfo* Nova::loadTexture(Nova::String name, Nova::String filename, N
 		}
 
 		//Give OpenGL the texture
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+		//Sized format so the array pool can copy it into a page
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, format, GL_UNSIGNED_BYTE, data);
 		glGenerateMipmap(GL_TEXTURE_2D);
 
 		//Clean up and get the texture struct ready
@@ -169,6 +209,12 @@ Nova::TextureInfo* Nova::loadTexture(Nova::String name, Nova::String filename, N
 		tex->name = name;
 		tex->path = filename;
 
+		//A copy goes into the array pool, so objects with different textures of this size can share draws
+		if (Nova::textureArrays)
+		{
+			Nova::textureArrayPool.add(*tex);
+		}
+
 		textureSet.push_back(tex);
 	}
 	else
@@ -193,6 +239,8 @@ void Nova::deleteTextures(Nova::Array<Nova::TextureInfo*>& textureSet)
 
 	textureSet.clear();
 	textureSet.shrink_to_fit();
+
+	Nova::glState.invalidate();
 }
 
 Nova::Matrix4 Nova::lookAt(const Nova::Vector3& position, const Nova::Vector3& target, const Nova::Vector3& up)
@@ -231,6 +279,17 @@ Nova::Matrix4 Nova::makePerspective(Nova::Float aspectRatio, Nova::Float fov, No
 	return proj;
 }
 
+Nova::Matrix4 Nova::makeOrthographic(Nova::Float left, Nova::Float right, Nova::Float bottom, Nova::Float top, Nova::Float near, Nova::Float far)
+{
+	Nova::Matrix4 proj;
+	proj << 2.0f / (right - left), 0.0f, 0.0f, -(right + left) / (right - left),
+			0.0f, 2.0f / (top - bottom), 0.0f, -(top + bottom) / (top - bottom),
+			0.0f, 0.0f, -2.0f / (far - near), -(far + near) / (far - near),
+			0.0f, 0.0f, 0.0f, 1.0f;
+
+	return proj;
+}
+
 //x: pitch, y: yaw, z: roll, angles in degrees
 Nova::Quaternion Nova::rotateFromEuler(Nova::Vector3 angles, bool isRadians)
 {
@@ -254,6 +313,82 @@ Nova::Quaternion Nova::rotateFromEuler(Nova::Vector3 angles, bool isRadians)
 	return rotation.normalized();
 }
 
+Nova::UInt64 Nova::hashBytes(const void* bytes, std::size_t count, Nova::UInt64 hash)
+{
+	const Nova::UByte* data = static_cast<const Nova::UByte*>(bytes);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		hash = (hash ^ data[i]) * 1099511628211ull;
+	}
+
+	return hash;
+}
+
+Nova::Float Nova::pointLightRadius(const Nova::Component::PointLight& light, Nova::Float cutoff)
+{
+	//Ambient is attenuated along with diffuse in the shaders, specular is never evaluated so it is left out
+	//This matches the intensity LightManager::selectLights ranks lights by
+	Nova::Float intensity = (light.base.ambient + light.base.diffuse).maxCoeff();
+
+	//Solve k + l*d + q*d^2 = intensity / cutoff for d
+	Nova::Float limit = intensity / cutoff - light.constant;
+
+	if (limit <= 0.0f)
+	{
+		return 0.0f;
+	}
+
+	if (light.quadratic > 0.0f)
+	{
+		return (-light.linear + sqrtf(light.linear * light.linear + 4.0f * light.quadratic * limit)) / (2.0f * light.quadratic);
+	}
+
+	if (light.linear > 0.0f)
+	{
+		return limit / light.linear;
+	}
+
+	//No falloff, the light reaches everything
+	return std::numeric_limits<Nova::Float>::infinity();
+}
+
+Nova::PointLightData Nova::makePointLightData(const Nova::Component::PointLight& light, const Nova::Vector3& position, Nova::Float cutoff)
+{
+	Nova::PointLightData data;
+
+	data.position << position, Nova::pointLightRadius(light, cutoff);
+
+	data.ambient << light.base.ambient, 0.0f;
+	data.diffuse << light.base.diffuse, 0.0f;
+	data.specular << light.base.specular, 0.0f;
+
+	data.attenuation << light.constant, light.linear, light.quadratic, 0.0f;
+
+	return data;
+}
+
+Nova::Component::WorldTransform Nova::composeTransform(const Nova::Component::Transform& transform)
+{
+	Nova::Component::WorldTransform world;
+
+	Nova::Matrix3 rotation = Nova::rotateFromEuler(transform.rotation).toRotationMatrix();
+
+	//Perform world space transformations
+	Nova::Affine3 model = Nova::Affine3::Identity();
+	model.translate(transform.position);
+	model.rotate(rotation);
+	model.scale(transform.scale);
+
+	world.model = model.matrix();
+
+	//For M = R * S the inverse transpose is R * S^-1, so no general inverse is needed
+	//A zero scale flattens the object, its normals are zeroed instead of becoming infinite
+	Nova::Vector3 inverseScale = transform.scale.unaryExpr([](Nova::Float s) { return s != 0.0f ? 1.0f / s : 0.0f; });
+	world.normal = rotation * inverseScale.asDiagonal();
+
+	return world;
+}
+
 Nova::Int Nova::saveScene(const Nova::String& filepath)
 {
 	std::cout << "Saving scene to file: " << filepath << std::endl;
@@ -346,6 +481,9 @@ Nova::Int Nova::saveScene(const Nova::String& filepath)
 			obj["mesh"] = m;
 		}
 
+		//Only static meshes are baked into the probes
+		obj["static"] = e.has<Nova::Component::Static>();
+
 		//Save point light info
 		if (e.has<Nova::Component::PointLight>())
 		{
@@ -384,6 +522,9 @@ Nova::Int Nova::saveScene(const Nova::String& filepath)
 		entities.append(obj);
 	}
 	root["entities"].append(entities);
+
+	//Light radii depend on the cutoff, a bake of the saved scene must use the same one
+	root["light_cutoff"] = Nova::lightManager.getAttenuationCutoff();
 	
 	Json::StreamWriterBuilder builder;
 	const std::string jsonFile = Json::writeString(builder, root);
@@ -391,6 +532,12 @@ Nova::Int Nova::saveScene(const Nova::String& filepath)
 	std::ofstream file(filepath);
 	file << jsonFile;
 
+	//Probes only match the scene they were baked from, so they are saved with it
+	if (!Nova::probeGrid.empty())
+	{
+		Nova::probeGrid.save(probeFilePath(filepath));
+	}
+
 	std::cout << "Saved!" << std::endl;
 
 	return 0;
@@ -411,6 +558,15 @@ Nova::Int Nova::loadScene(const Nova::String& filepath)
 
 	clearScene();
 
+	//Scenes saved before the cutoff was recorded used the default
+	Nova::lightManager.setAttenuationCutoff(root.get("light_cutoff", Nova::CONST::LIGHT_ATTENUATION_CUTOFF).asFloat());
+
+	//A scene baked before keeps its probes next to it
+	if (Nova::probeGrid.load(probeFilePath(filepath)))
+	{
+		Nova::probeGrid.upload();
+	}
+
 	//Properly load everything back into the scene
 	std::cout << root["meshes"][0]["name"] << std::endl;
 	loadCubeMesh();
@@ -421,10 +577,14 @@ Nova::Int Nova::loadScene(const Nova::String& filepath)
 void Nova::clearScene()
 {
 	deleteTextures(Nova::globalTextures);
+	Nova::textureArrayPool.clear();
 	deleteMeshes(Nova::globalMeshes);
 
 	Nova::lightManager.deleteLights();
 
+	Nova::probeGrid.clear();
+	Nova::probeGrid.upload();
+
 	for (auto entity : Nova::entities)
 	{
 		entity.destruct();
@@ -433,3 +593,148 @@ void Nova::clearScene()
 	Nova::entities.clear();
 	Nova::entities.shrink_to_fit();
 }
+
+
+Nova::String Nova::probeFilePath(const Nova::String& scenePath)
+{
+	//Only a dot after the last separator starts an extension
+	std::size_t dot = scenePath.find_last_of('.');
+	std::size_t separator = scenePath.find_last_of("/\\");
+
+	if (dot == Nova::String::npos || (separator != Nova::String::npos && dot < separator))
+	{
+		return scenePath + ".probes";
+	}
+
+	return scenePath.substr(0, dot) + ".probes";
+}
+
+//Vertices and indices of a mesh kept on the CPU for baking
+typedef std::pair<Nova::Array<Nova::VertexData>, Nova::Array<Nova::UInt>> BakeGeometry;
+
+//Built in meshes are generated once per bake however many objects use them, returns null for meshes without a CPU copy
+static const BakeGeometry* findBakeGeometry(const Nova::String& name, std::unordered_map<Nova::String, BakeGeometry>& cache)
+{
+	auto it = cache.find(name);
+	if (it == cache.end())
+	{
+		BakeGeometry geometry;
+		if (!Nova::generateMesh(name, geometry.first, geometry.second))
+		{
+			std::cerr << "WARNING: Mesh " << name << " has no CPU copy and is left out of the bake." << std::endl;
+		}
+
+		it = cache.emplace(name, std::move(geometry)).first;
+	}
+
+	return it->second.second.empty() ? nullptr : &it->second;
+}
+
+static Nova::Vector3 readVector3(const Json::Value& value)
+{
+	return Nova::Vector3(value[0].asFloat(), value[1].asFloat(), value[2].asFloat());
+}
+
+void Nova::bakeProbes()
+{
+	Nova::ProbeBaker baker;
+	std::unordered_map<Nova::String, BakeGeometry> cache;
+
+	//Light cubes are not occluders, they would shadow their own light
+	Nova::ecs.each([&](flecs::entity e, const Nova::Component::WorldTransform& transform, const Nova::Component::Mesh& mesh)
+	{
+		if (!e.has<Nova::Component::Static>() || e.has<Nova::Component::PointLight>())
+		{
+			return;
+		}
+
+		if (const BakeGeometry* geometry = findBakeGeometry(mesh.meshInfo.name, cache))
+		{
+			baker.addMesh(geometry->first, geometry->second, transform.model);
+		}
+	});
+
+	Nova::ecs.each([&](const Nova::Component::Transform& transform, const Nova::Component::PointLight& light)
+	{
+		baker.addLight(Nova::makePointLightData(light, transform.position, Nova::lightManager.getAttenuationCutoff()));
+	});
+
+	baker.bake(Nova::probeGrid, Nova::jobSystem);
+	Nova::probeGrid.upload();
+}
+
+Nova::Int Nova::bakeSceneFile(const Nova::String& filepath)
+{
+	std::cout << "Baking probes for scene: " << filepath << std::endl;
+
+	Nova::String jsonData = readFileToString(filepath);
+	JSONCPP_STRING err;
+	Json::Value root;
+
+	Json::CharReaderBuilder builder;
+	const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+	if (!reader->parse(jsonData.c_str(), jsonData.c_str() + jsonData.length(), &root, &err)) {
+		std::cerr << "ERROR: " << err << std::endl;
+		return -1;
+	}
+
+	Nova::ProbeBaker baker;
+	std::unordered_map<Nova::String, BakeGeometry> cache;
+
+	//Radii must come from the cutoff the scene was edited with, or the probes would not match the editor's bake
+	Nova::Float cutoff = root.get("light_cutoff", Nova::CONST::LIGHT_ATTENUATION_CUTOFF).asFloat();
+
+	//saveScene stores the entity list as the first element of "entities"
+	for (const auto& obj : root["entities"][0])
+	{
+		if (!obj.isMember("transform"))
+		{
+			continue;
+		}
+
+		Nova::Component::Transform transform;
+		transform.position = readVector3(obj["transform"]["position"]);
+		transform.rotation = readVector3(obj["transform"]["rotation"]);
+		transform.scale = readVector3(obj["transform"]["scale"]);
+
+		if (obj.isMember("point_light"))
+		{
+			const Json::Value& pl = obj["point_light"];
+
+			Nova::Component::PointLight light;
+			light.base.ambient = readVector3(pl["base"]["ambient"]);
+			light.base.diffuse = readVector3(pl["base"]["diffuse"]);
+			light.base.specular = readVector3(pl["base"]["specular"]);
+			light.quadratic = pl["quadratic"].asFloat();
+			light.linear = pl["linear"].asFloat();
+			light.constant = pl["constant"].asFloat();
+
+			baker.addLight(Nova::makePointLightData(light, transform.position, cutoff));
+			continue;
+		}
+
+		if (obj["static"].asBool() && obj.isMember("mesh"))
+		{
+			if (const BakeGeometry* geometry = findBakeGeometry(obj["mesh"]["name"].asString(), cache))
+			{
+				baker.addMesh(geometry->first, geometry->second, Nova::composeTransform(transform).model);
+			}
+		}
+	}
+
+	Nova::ProbeGrid grid;
+	if (!baker.bake(grid, Nova::jobSystem))
+	{
+		return -1;
+	}
+
+	Nova::String probePath = probeFilePath(filepath);
+	if (!grid.save(probePath))
+	{
+		return -1;
+	}
+
+	std::cout << "Saved probes to file: " << probePath << std::endl;
+
+	return 0;
+}
\ No newline at end of file
@@ -29,9 +29,35 @@ namespace Nova
     
     Nova::Shader unlitShader;
     Nova::Shader forwardShader;
+    Nova::Shader clusteredShader;
     Nova::Shader lightSourceShader;
     Nova::Shader activeObjShader;
-    Nova::ShaderProgram activeProgram;
+    Nova::Shader normalBenchShader;
+    Nova::Shader gbufferShader;
+    Nova::Shader deferredResolveShader;
+    Nova::Shader lightVolumeShader;
+    Nova::Shader shadowShader;
+    Nova::Shader depthPrePassShader;
+    Nova::Shader overdrawShader;
+    Nova::Shader* activeShader;
+    Nova::LightingMode lightingMode = Nova::LightingMode::FORWARD;
+    bool depthPrePass = false;
+    bool textureArrays = false;
+
+    Nova::StreamBuffer instanceStream;
+    Nova::StreamBuffer indirectStream;
+    Nova::StreamBuffer clusterStream;
+    Nova::StreamBuffer shadowStream;
+    Nova::StreamBuffer lightStream;
+    Nova::JobSystem jobSystem;
+    Nova::MeshPool meshPool;
+    Nova::GPUTimer objectPassTimer;
+    Nova::GPUTimer lightingPassTimer;
+    Nova::GPUTimer depthPrePassTimer;
+    Nova::GPUQuery shadedSamplesQuery(GL_SAMPLES_PASSED);
+    Nova::DeferredRenderer deferredRenderer;
+    Nova::ShadowMaps shadowMaps;
+    Nova::ProbeGrid probeGrid;
 
     Nova::Editor::EditorCamera editorCamera;
 
@@ -40,6 +66,13 @@ namespace Nova
     Nova::Array<Nova::Entity> entities;
     Nova::Lighting::LightManager lightManager;
     Nova::ShaderManager shaderManager;
+    Nova::ProgramCache programCache;
+    Nova::ShaderSourceCache shaderSources;
+    Nova::TextureArrayPool textureArrayPool;
+    Nova::GLState glState;
+    Nova::FrameStats frameStats;
+    Nova::FrameConstants frameConstants;
+    Nova::StreamBuffer frameConstantsStream;
 
     //Begins graphics specific setup for items like GLFW, GLAD, ImGUI, etc.
     Nova::Int initGraphics(void)
@@ -80,10 +113,10 @@ namespace Nova
 
         //---------------OpenGL---------------//
         //Set the viewport
-        glViewport(0, 0, Nova::CONST::SCREEN_WIDTH, Nova::CONST::SCREEN_HEIGHT);
+        glState.setViewport(0, 0, Nova::CONST::SCREEN_WIDTH, Nova::CONST::SCREEN_HEIGHT);
         
         //Allow OpenGL settings
-        glEnable(GL_DEPTH_TEST);
+        glState.setDepthTest(true);
 
         //Increase lines thickness for highlighting objects
         glLineWidth(3.3f);
@@ -100,18 +133,81 @@ namespace Nova
 
 
         //---------------Nova---------------//
+        //Programs built before are loaded from their binaries, compare the timings of a cold and a warm start
+        programCache.init(Nova::CONST::PROGRAM_CACHE_DIRECTORY);
+
+        //Picks how programs build off the main thread, must come before any shader starts building
+        shaderManager.init(window);
+        auto shaderStart = std::chrono::steady_clock::now();
+
         //Create shader
         unlitShader.init(SHADER_PATH("vertex.vert"), SHADER_PATH("unlit.frag"));
         forwardShader.init(SHADER_PATH("vertex.vert"), SHADER_PATH("forward.frag"));
+        clusteredShader.init(SHADER_PATH("vertex.vert"), SHADER_PATH("clustered.frag"));
         lightSourceShader.init(SHADER_PATH("lights/vertex.vert"), SHADER_PATH("lights/fragment.frag"));
         activeObjShader.init(SHADER_PATH("active/vertex.vert"), SHADER_PATH("active/geometry.geom"), SHADER_PATH("active/fragment.frag"));
+        normalBenchShader.init(SHADER_PATH("bench/inverse_normal.vert"), SHADER_PATH("forward.frag"));
+        gbufferShader.init(SHADER_PATH("vertex.vert"), SHADER_PATH("deferred/gbuffer.frag"));
+        deferredResolveShader.init(SHADER_PATH("deferred/fullscreen.vert"), SHADER_PATH("deferred/resolve.frag"));
+        lightVolumeShader.init(SHADER_PATH("deferred/light_volume.vert"), SHADER_PATH("deferred/light_volume.frag"));
+        shadowShader.init(SHADER_PATH("shadow/depth.vert"), SHADER_PATH("shadow/depth.frag"));
+        depthPrePassShader.init(SHADER_PATH("prepass/depth.vert"), SHADER_PATH("shadow/depth.frag"));
+        overdrawShader.init(SHADER_PATH("vertex.vert"), SHADER_PATH("overdraw.frag"));
 
         shaderManager.addShader(unlitShader);
         shaderManager.addShader(forwardShader);
+        shaderManager.addShader(clusteredShader);
         shaderManager.addShader(lightSourceShader);
         shaderManager.addShader(activeObjShader);
-
-        lightManager.addProgram(forwardShader.getProgram());
+        shaderManager.addShader(normalBenchShader);
+        shaderManager.addShader(gbufferShader);
+        shaderManager.addShader(deferredResolveShader);
+        shaderManager.addShader(lightVolumeShader);
+        shaderManager.addShader(shadowShader);
+        shaderManager.addShader(depthPrePassShader);
+        shaderManager.addShader(overdrawShader);
+
+        //Baked variants are what baked mode falls back to, a generic program would read light lists that are not bound
+        shaderManager.getVariant(forwardShader, Nova::ShaderFeature::BAKED_LIGHTING);
+        shaderManager.getVariant(forwardShader, Nova::ShaderFeature::BAKED_LIGHTING | Nova::ShaderFeature::UNTEXTURED);
+
+        //The builds above overlap, the editor only needs them done before its first frame
+        shaderManager.waitForBuilds();
+
+        std::chrono::duration<Nova::Float, std::milli> shaderTime = std::chrono::steady_clock::now() - shaderStart;
+        std::cout << "Shaders ready in " << shaderTime.count() << " ms, " << programCache.getHits() << " loaded from the cache and "
+            << programCache.getMisses() << " compiled" << std::endl;
+        std::cout << "Shader sources: " << shaderSources.getFilesRead() << " files read, " << shaderSources.getExpansions() << " stages expanded, "
+            << shaderSources.getHits() << " expansions reused and " << shaderManager.getStageReuseCount() << " stage objects shared" << std::endl;
+
+        //Every mesh is stored in the pool, so it must exist before any mesh loads
+        meshPool.init(Nova::CONST::MESH_POOL_VERTEX_CAPACITY, Nova::CONST::MESH_POOL_INDEX_CAPACITY);
+
+        //Per-frame data is written straight into mapped ring buffers, ranges are bound as they are used
+        Nova::Int uniformAlignment = 0, storageAlignment = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+        glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
+
+        instanceStream.init(Nova::CONST::INSTANCE_STREAM_SIZE, storageAlignment);
+        indirectStream.init(Nova::CONST::INDIRECT_STREAM_SIZE, sizeof(Nova::UInt));
+        frameConstantsStream.init(sizeof(Nova::FrameConstants), uniformAlignment);
+        clusterStream.init(Nova::CONST::CLUSTER_STREAM_SIZE, storageAlignment);
+        shadowStream.init(sizeof(Nova::ShadowData), uniformAlignment);
+        lightStream.init(Nova::CONST::LIGHT_STREAM_SIZE);
+
+        //Point lights are read from a storage buffer by every lit program, their changes are staged in lightStream
+        lightManager.init();
+
+        jobSystem.init();
+
+        objectPassTimer.init();
+        lightingPassTimer.init();
+        depthPrePassTimer.init();
+        shadedSamplesQuery.init();
+
+        deferredRenderer.init(Nova::CONST::SCREEN_WIDTH, Nova::CONST::SCREEN_HEIGHT);
+        shadowMaps.init(Nova::CONST::SHADOW_MAP_SIZE);
+        probeGrid.init();
 
         stbi_set_flip_vertically_on_load(true);
         
@@ -120,16 +216,70 @@ namespace Nova
 
     Nova::Int initECS()
     {
-        //Render system includes transformation information
-        Nova::ecs.system<const Nova::Component::Transform, const Nova::Component::Mesh, const Nova::Component::PointLight>("Point Light Render")
-            .run(PointLightRenderSystem);
+        //Camera data must be ready before any render system runs
+        Nova::ecs.system("Frame Constants")
+            .kind(flecs::PreUpdate)
+            .run(FrameConstantsSystem);
+
+        //Culling needs this frame's camera, so it is declared after the frame constants
+        Nova::ecs.system<const Nova::Component::WorldBounds, Nova::Component::Visibility>("Frustum Cull")
+            .kind(flecs::PreUpdate)
+            .run(FrustumCullSystem);
+
+        //Model matrices are only rebuilt when a Transform is set or flagged as modified
+        Nova::ecs.observer<const Nova::Component::Transform>("World Transform")
+            .event(flecs::OnSet)
+            .each(WorldTransformObserver);
+
+        //World bounds follow the model matrix and the mesh
+        Nova::ecs.observer<const Nova::Component::WorldTransform, const Nova::Component::Mesh>("World Bounds")
+            .event(flecs::OnSet)
+            .each(WorldBoundsObserver);
+
+        //Lights only reach the GPU when they change, the observers queue them for the upload system
+        Nova::ecs.observer<const Nova::Component::Transform, const Nova::Component::PointLight>("Point Light Change")
+            .event(flecs::OnSet)
+            .each(PointLightChangeObserver);
+
+        Nova::ecs.observer<const Nova::Component::PointLight>("Point Light Remove")
+            .event(flecs::OnRemove)
+            .each(PointLightRemoveObserver);
+
+        //Static casters are cached in the shadow maps, any change to one invalidates the caches
+        Nova::ecs.observer("Static Casters")
+            .with<Nova::Component::WorldTransform>()
+            .with<Nova::Component::Mesh>()
+            .with<Nova::Component::Static>()
+            .event(flecs::OnAdd)
+            .event(flecs::OnSet)
+            .event(flecs::OnRemove)
+            .each(StaticCasterObserver);
+
+        Nova::ecs.system("Light Upload")
+            .kind(flecs::PreUpdate)
+            .run(LightUploadSystem);
+
+        //Clusters need this frame's camera and light bounds, so they are built after both
+        Nova::ecs.system("Light Clusters")
+            .kind(flecs::PreUpdate)
+            .run(LightClusterSystem);
+
+        //Shadow maps must be ready before anything lit samples them
+        Nova::ecs.system<const Nova::Component::WorldTransform, const Nova::Component::Mesh, const Nova::Component::WorldBounds>("Directional Shadows")
+            .without<Nova::Component::PointLight>()
+            .without<Nova::Component::DirectionalLight>()
+            .run(DirectionalShadowSystem);
 
-        //Render system includes transformation information
-        Nova::ecs.system<const Nova::Component::Transform, const Nova::Component::Mesh>("Object Render")
+        //Objects are drawn first, deferred lighting resolves the scene before the forward passes after it
+        Nova::ecs.system<const Nova::Component::WorldTransform, const Nova::Component::Mesh, const Nova::Component::Visibility, const Nova::Component::WorldBounds>("Object Render")
             .without<Nova::Component::PointLight>()
             .without<Nova::Component::DirectionalLight>() //TODO: Add more lighting types as needed
             .run(ObjectRenderSystem);
 
+        //Render system includes transformation information
+        Nova::ecs.system<const Nova::Component::WorldTransform, const Nova::Component::Mesh, const Nova::Component::PointLight, const Nova::Component::Visibility>("Point Light Render")
+            .run(PointLightRenderSystem);
+
         //Load meshes
         loadCubeMesh();
 
@@ -148,6 +298,7 @@ namespace Nova
             cubes[i].set_doc_name(name.c_str());
             
             cubes[i].set<Nova::Component::Transform>(transform);
+            cubes[i].add<Nova::Component::Static>();
 
             entities.push_back(cubes[i]);
         }
@@ -179,11 +330,17 @@ namespace Nova
         pointLight.set_doc_name("Light 0");
         entities.push_back(pointLight);
         lightManager.addPointLight(pointLight);
+
         //TODO: Gather all point lights on game startup
         //TODO: See if flecs can do some kind of component initialization
 
+        //Add a sun, the test cubes cast their shadows with it
+        auto sun = Nova::createDirectionalLight();
+        sun.set_doc_name("Sun");
+        entities.push_back(sun);
+
         activeObj = cam;
-        activeProgram = forwardShader.getProgram();
+        activeShader = &forwardShader;
 
         return 0;
     }
@@ -201,6 +358,9 @@ namespace Nova
             glfwPollEvents();
             processInput(Nova::window, Nova::editorCamera, Nova::deltaTime);
 
+            //Swap in any programs that finished building since the last frame
+            shaderManager.update();
+
             //Let ImGUI work
             ImGui_ImplOpenGL3_NewFrame();
             ImGui_ImplGlfw_NewFrame();
@@ -212,6 +372,7 @@ namespace Nova
             
             Nova::EditorUI::ShowObjectProperties(activeObj);
             Nova::EditorUI::ShowObjectList(Nova::entities, activeObj);
+            Nova::EditorUI::ShowStatistics(Nova::frameStats);
 
             ImGui::Render();
 
@@ -219,11 +380,33 @@ namespace Nova
             glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+            //Statistics were displayed above, start counting for this frame
+            Nova::frameStats = {};
+
+            //Claim this frame's stream regions, blocking only if the GPU is still reading them
+            instanceStream.beginFrame();
+            indirectStream.beginFrame();
+            frameConstantsStream.beginFrame();
+            clusterStream.beginFrame();
+            shadowStream.beginFrame();
+            lightStream.beginFrame();
+
             //Run the systems and pipelines
             ecs.progress(Nova::deltaTime);
 
+            //Every command reading the streams has been issued
+            instanceStream.endFrame();
+            indirectStream.endFrame();
+            frameConstantsStream.endFrame();
+            clusterStream.endFrame();
+            shadowStream.endFrame();
+            lightStream.endFrame();
+
             //Swap buffers
             ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+            //ImGui binds its own objects, do not trust the shadowed state afterwards
+            glState.invalidate();
             glfwSwapBuffers(window);
 
             //Framerate lock at 60fps, TESTING ONLY
@@ -242,6 +425,26 @@ namespace Nova
     void quit()
     {
         deleteTextures(globalTextures);
+        textureArrayPool.clear();
+        instanceStream.destroy();
+        indirectStream.destroy();
+        deleteMeshes(globalMeshes);
+        deferredRenderer.destroy();
+        meshPool.destroy();
+        frameConstantsStream.destroy();
+        clusterStream.destroy();
+        shadowStream.destroy();
+        shadowMaps.destroy();
+        probeGrid.destroy();
+        objectPassTimer.destroy();
+        lightingPassTimer.destroy();
+        depthPrePassTimer.destroy();
+        shadedSamplesQuery.destroy();
+        lightManager.destroy();
+        lightStream.destroy();
+
+        jobSystem.shutdown();
+        shaderManager.shutdown();
 
         ImGui_ImplOpenGL3_Shutdown();
         ImGui_ImplGlfw_Shutdown();
@@ -252,8 +455,18 @@ namespace Nova
     }
 }
 
-Nova::Int main(void)
+Nova::Int main(int argc, char** argv)
 {
+    //Baking only needs the scene file and the worker threads, so it runs without a window
+    if (argc >= 3 && Nova::String(argv[1]) == "--bake")
+    {
+        Nova::jobSystem.init();
+        Nova::Int result = Nova::bakeSceneFile(argv[2]);
+        Nova::jobSystem.shutdown();
+
+        return result;
+    }
+
     Nova::initGraphics();
     
     Nova::initECS();